@@ -0,0 +1,460 @@
+/* This file is automatically generated. CRC-32 and CRC-64 lookup tables */
+#ifndef _CRCTABLE_H_
+#define _CRCTABLE_H_
+
+#define CRC32_TABLE0 \
+    0x00000000UL, 0x77073096UL, 0xEE0E612CUL, 0x990951BAUL, 0x076DC419UL, 0x706AF48FUL, \
+    0xE963A535UL, 0x9E6495A3UL, 0x0EDB8832UL, 0x79DCB8A4UL, 0xE0D5E91EUL, 0x97D2D988UL, \
+    0x09B64C2BUL, 0x7EB17CBDUL, 0xE7B82D07UL, 0x90BF1D91UL, 0x1DB71064UL, 0x6AB020F2UL, \
+    0xF3B97148UL, 0x84BE41DEUL, 0x1ADAD47DUL, 0x6DDDE4EBUL, 0xF4D4B551UL, 0x83D385C7UL, \
+    0x136C9856UL, 0x646BA8C0UL, 0xFD62F97AUL, 0x8A65C9ECUL, 0x14015C4FUL, 0x63066CD9UL, \
+    0xFA0F3D63UL, 0x8D080DF5UL, 0x3B6E20C8UL, 0x4C69105EUL, 0xD56041E4UL, 0xA2677172UL, \
+    0x3C03E4D1UL, 0x4B04D447UL, 0xD20D85FDUL, 0xA50AB56BUL, 0x35B5A8FAUL, 0x42B2986CUL, \
+    0xDBBBC9D6UL, 0xACBCF940UL, 0x32D86CE3UL, 0x45DF5C75UL, 0xDCD60DCFUL, 0xABD13D59UL, \
+    0x26D930ACUL, 0x51DE003AUL, 0xC8D75180UL, 0xBFD06116UL, 0x21B4F4B5UL, 0x56B3C423UL, \
+    0xCFBA9599UL, 0xB8BDA50FUL, 0x2802B89EUL, 0x5F058808UL, 0xC60CD9B2UL, 0xB10BE924UL, \
+    0x2F6F7C87UL, 0x58684C11UL, 0xC1611DABUL, 0xB6662D3DUL, 0x76DC4190UL, 0x01DB7106UL, \
+    0x98D220BCUL, 0xEFD5102AUL, 0x71B18589UL, 0x06B6B51FUL, 0x9FBFE4A5UL, 0xE8B8D433UL, \
+    0x7807C9A2UL, 0x0F00F934UL, 0x9609A88EUL, 0xE10E9818UL, 0x7F6A0DBBUL, 0x086D3D2DUL, \
+    0x91646C97UL, 0xE6635C01UL, 0x6B6B51F4UL, 0x1C6C6162UL, 0x856530D8UL, 0xF262004EUL, \
+    0x6C0695EDUL, 0x1B01A57BUL, 0x8208F4C1UL, 0xF50FC457UL, 0x65B0D9C6UL, 0x12B7E950UL, \
+    0x8BBEB8EAUL, 0xFCB9887CUL, 0x62DD1DDFUL, 0x15DA2D49UL, 0x8CD37CF3UL, 0xFBD44C65UL, \
+    0x4DB26158UL, 0x3AB551CEUL, 0xA3BC0074UL, 0xD4BB30E2UL, 0x4ADFA541UL, 0x3DD895D7UL, \
+    0xA4D1C46DUL, 0xD3D6F4FBUL, 0x4369E96AUL, 0x346ED9FCUL, 0xAD678846UL, 0xDA60B8D0UL, \
+    0x44042D73UL, 0x33031DE5UL, 0xAA0A4C5FUL, 0xDD0D7CC9UL, 0x5005713CUL, 0x270241AAUL, \
+    0xBE0B1010UL, 0xC90C2086UL, 0x5768B525UL, 0x206F85B3UL, 0xB966D409UL, 0xCE61E49FUL, \
+    0x5EDEF90EUL, 0x29D9C998UL, 0xB0D09822UL, 0xC7D7A8B4UL, 0x59B33D17UL, 0x2EB40D81UL, \
+    0xB7BD5C3BUL, 0xC0BA6CADUL, 0xEDB88320UL, 0x9ABFB3B6UL, 0x03B6E20CUL, 0x74B1D29AUL, \
+    0xEAD54739UL, 0x9DD277AFUL, 0x04DB2615UL, 0x73DC1683UL, 0xE3630B12UL, 0x94643B84UL, \
+    0x0D6D6A3EUL, 0x7A6A5AA8UL, 0xE40ECF0BUL, 0x9309FF9DUL, 0x0A00AE27UL, 0x7D079EB1UL, \
+    0xF00F9344UL, 0x8708A3D2UL, 0x1E01F268UL, 0x6906C2FEUL, 0xF762575DUL, 0x806567CBUL, \
+    0x196C3671UL, 0x6E6B06E7UL, 0xFED41B76UL, 0x89D32BE0UL, 0x10DA7A5AUL, 0x67DD4ACCUL, \
+    0xF9B9DF6FUL, 0x8EBEEFF9UL, 0x17B7BE43UL, 0x60B08ED5UL, 0xD6D6A3E8UL, 0xA1D1937EUL, \
+    0x38D8C2C4UL, 0x4FDFF252UL, 0xD1BB67F1UL, 0xA6BC5767UL, 0x3FB506DDUL, 0x48B2364BUL, \
+    0xD80D2BDAUL, 0xAF0A1B4CUL, 0x36034AF6UL, 0x41047A60UL, 0xDF60EFC3UL, 0xA867DF55UL, \
+    0x316E8EEFUL, 0x4669BE79UL, 0xCB61B38CUL, 0xBC66831AUL, 0x256FD2A0UL, 0x5268E236UL, \
+    0xCC0C7795UL, 0xBB0B4703UL, 0x220216B9UL, 0x5505262FUL, 0xC5BA3BBEUL, 0xB2BD0B28UL, \
+    0x2BB45A92UL, 0x5CB36A04UL, 0xC2D7FFA7UL, 0xB5D0CF31UL, 0x2CD99E8BUL, 0x5BDEAE1DUL, \
+    0x9B64C2B0UL, 0xEC63F226UL, 0x756AA39CUL, 0x026D930AUL, 0x9C0906A9UL, 0xEB0E363FUL, \
+    0x72076785UL, 0x05005713UL, 0x95BF4A82UL, 0xE2B87A14UL, 0x7BB12BAEUL, 0x0CB61B38UL, \
+    0x92D28E9BUL, 0xE5D5BE0DUL, 0x7CDCEFB7UL, 0x0BDBDF21UL, 0x86D3D2D4UL, 0xF1D4E242UL, \
+    0x68DDB3F8UL, 0x1FDA836EUL, 0x81BE16CDUL, 0xF6B9265BUL, 0x6FB077E1UL, 0x18B74777UL, \
+    0x88085AE6UL, 0xFF0F6A70UL, 0x66063BCAUL, 0x11010B5CUL, 0x8F659EFFUL, 0xF862AE69UL, \
+    0x616BFFD3UL, 0x166CCF45UL, 0xA00AE278UL, 0xD70DD2EEUL, 0x4E048354UL, 0x3903B3C2UL, \
+    0xA7672661UL, 0xD06016F7UL, 0x4969474DUL, 0x3E6E77DBUL, 0xAED16A4AUL, 0xD9D65ADCUL, \
+    0x40DF0B66UL, 0x37D83BF0UL, 0xA9BCAE53UL, 0xDEBB9EC5UL, 0x47B2CF7FUL, 0x30B5FFE9UL, \
+    0xBDBDF21CUL, 0xCABAC28AUL, 0x53B39330UL, 0x24B4A3A6UL, 0xBAD03605UL, 0xCDD70693UL, \
+    0x54DE5729UL, 0x23D967BFUL, 0xB3667A2EUL, 0xC4614AB8UL, 0x5D681B02UL, 0x2A6F2B94UL, \
+    0xB40BBE37UL, 0xC30C8EA1UL, 0x5A05DF1BUL, 0x2D02EF8DUL
+
+#define CRC32_TABLE1 \
+    0x00000000UL, 0x191B3141UL, 0x32366282UL, 0x2B2D53C3UL, 0x646CC504UL, 0x7D77F445UL, \
+    0x565AA786UL, 0x4F4196C7UL, 0xC8D98A08UL, 0xD1C2BB49UL, 0xFAEFE88AUL, 0xE3F4D9CBUL, \
+    0xACB54F0CUL, 0xB5AE7E4DUL, 0x9E832D8EUL, 0x87981CCFUL, 0x4AC21251UL, 0x53D92310UL, \
+    0x78F470D3UL, 0x61EF4192UL, 0x2EAED755UL, 0x37B5E614UL, 0x1C98B5D7UL, 0x05838496UL, \
+    0x821B9859UL, 0x9B00A918UL, 0xB02DFADBUL, 0xA936CB9AUL, 0xE6775D5DUL, 0xFF6C6C1CUL, \
+    0xD4413FDFUL, 0xCD5A0E9EUL, 0x958424A2UL, 0x8C9F15E3UL, 0xA7B24620UL, 0xBEA97761UL, \
+    0xF1E8E1A6UL, 0xE8F3D0E7UL, 0xC3DE8324UL, 0xDAC5B265UL, 0x5D5DAEAAUL, 0x44469FEBUL, \
+    0x6F6BCC28UL, 0x7670FD69UL, 0x39316BAEUL, 0x202A5AEFUL, 0x0B07092CUL, 0x121C386DUL, \
+    0xDF4636F3UL, 0xC65D07B2UL, 0xED705471UL, 0xF46B6530UL, 0xBB2AF3F7UL, 0xA231C2B6UL, \
+    0x891C9175UL, 0x9007A034UL, 0x179FBCFBUL, 0x0E848DBAUL, 0x25A9DE79UL, 0x3CB2EF38UL, \
+    0x73F379FFUL, 0x6AE848BEUL, 0x41C51B7DUL, 0x58DE2A3CUL, 0xF0794F05UL, 0xE9627E44UL, \
+    0xC24F2D87UL, 0xDB541CC6UL, 0x94158A01UL, 0x8D0EBB40UL, 0xA623E883UL, 0xBF38D9C2UL, \
+    0x38A0C50DUL, 0x21BBF44CUL, 0x0A96A78FUL, 0x138D96CEUL, 0x5CCC0009UL, 0x45D73148UL, \
+    0x6EFA628BUL, 0x77E153CAUL, 0xBABB5D54UL, 0xA3A06C15UL, 0x888D3FD6UL, 0x91960E97UL, \
+    0xDED79850UL, 0xC7CCA911UL, 0xECE1FAD2UL, 0xF5FACB93UL, 0x7262D75CUL, 0x6B79E61DUL, \
+    0x4054B5DEUL, 0x594F849FUL, 0x160E1258UL, 0x0F152319UL, 0x243870DAUL, 0x3D23419BUL, \
+    0x65FD6BA7UL, 0x7CE65AE6UL, 0x57CB0925UL, 0x4ED03864UL, 0x0191AEA3UL, 0x188A9FE2UL, \
+    0x33A7CC21UL, 0x2ABCFD60UL, 0xAD24E1AFUL, 0xB43FD0EEUL, 0x9F12832DUL, 0x8609B26CUL, \
+    0xC94824ABUL, 0xD05315EAUL, 0xFB7E4629UL, 0xE2657768UL, 0x2F3F79F6UL, 0x362448B7UL, \
+    0x1D091B74UL, 0x04122A35UL, 0x4B53BCF2UL, 0x52488DB3UL, 0x7965DE70UL, 0x607EEF31UL, \
+    0xE7E6F3FEUL, 0xFEFDC2BFUL, 0xD5D0917CUL, 0xCCCBA03DUL, 0x838A36FAUL, 0x9A9107BBUL, \
+    0xB1BC5478UL, 0xA8A76539UL, 0x3B83984BUL, 0x2298A90AUL, 0x09B5FAC9UL, 0x10AECB88UL, \
+    0x5FEF5D4FUL, 0x46F46C0EUL, 0x6DD93FCDUL, 0x74C20E8CUL, 0xF35A1243UL, 0xEA412302UL, \
+    0xC16C70C1UL, 0xD8774180UL, 0x9736D747UL, 0x8E2DE606UL, 0xA500B5C5UL, 0xBC1B8484UL, \
+    0x71418A1AUL, 0x685ABB5BUL, 0x4377E898UL, 0x5A6CD9D9UL, 0x152D4F1EUL, 0x0C367E5FUL, \
+    0x271B2D9CUL, 0x3E001CDDUL, 0xB9980012UL, 0xA0833153UL, 0x8BAE6290UL, 0x92B553D1UL, \
+    0xDDF4C516UL, 0xC4EFF457UL, 0xEFC2A794UL, 0xF6D996D5UL, 0xAE07BCE9UL, 0xB71C8DA8UL, \
+    0x9C31DE6BUL, 0x852AEF2AUL, 0xCA6B79EDUL, 0xD37048ACUL, 0xF85D1B6FUL, 0xE1462A2EUL, \
+    0x66DE36E1UL, 0x7FC507A0UL, 0x54E85463UL, 0x4DF36522UL, 0x02B2F3E5UL, 0x1BA9C2A4UL, \
+    0x30849167UL, 0x299FA026UL, 0xE4C5AEB8UL, 0xFDDE9FF9UL, 0xD6F3CC3AUL, 0xCFE8FD7BUL, \
+    0x80A96BBCUL, 0x99B25AFDUL, 0xB29F093EUL, 0xAB84387FUL, 0x2C1C24B0UL, 0x350715F1UL, \
+    0x1E2A4632UL, 0x07317773UL, 0x4870E1B4UL, 0x516BD0F5UL, 0x7A468336UL, 0x635DB277UL, \
+    0xCBFAD74EUL, 0xD2E1E60FUL, 0xF9CCB5CCUL, 0xE0D7848DUL, 0xAF96124AUL, 0xB68D230BUL, \
+    0x9DA070C8UL, 0x84BB4189UL, 0x03235D46UL, 0x1A386C07UL, 0x31153FC4UL, 0x280E0E85UL, \
+    0x674F9842UL, 0x7E54A903UL, 0x5579FAC0UL, 0x4C62CB81UL, 0x8138C51FUL, 0x9823F45EUL, \
+    0xB30EA79DUL, 0xAA1596DCUL, 0xE554001BUL, 0xFC4F315AUL, 0xD7626299UL, 0xCE7953D8UL, \
+    0x49E14F17UL, 0x50FA7E56UL, 0x7BD72D95UL, 0x62CC1CD4UL, 0x2D8D8A13UL, 0x3496BB52UL, \
+    0x1FBBE891UL, 0x06A0D9D0UL, 0x5E7EF3ECUL, 0x4765C2ADUL, 0x6C48916EUL, 0x7553A02FUL, \
+    0x3A1236E8UL, 0x230907A9UL, 0x0824546AUL, 0x113F652BUL, 0x96A779E4UL, 0x8FBC48A5UL, \
+    0xA4911B66UL, 0xBD8A2A27UL, 0xF2CBBCE0UL, 0xEBD08DA1UL, 0xC0FDDE62UL, 0xD9E6EF23UL, \
+    0x14BCE1BDUL, 0x0DA7D0FCUL, 0x268A833FUL, 0x3F91B27EUL, 0x70D024B9UL, 0x69CB15F8UL, \
+    0x42E6463BUL, 0x5BFD777AUL, 0xDC656BB5UL, 0xC57E5AF4UL, 0xEE530937UL, 0xF7483876UL, \
+    0xB809AEB1UL, 0xA1129FF0UL, 0x8A3FCC33UL, 0x9324FD72UL
+
+#define CRC32_TABLE2 \
+    0x00000000UL, 0x01C26A37UL, 0x0384D46EUL, 0x0246BE59UL, 0x0709A8DCUL, 0x06CBC2EBUL, \
+    0x048D7CB2UL, 0x054F1685UL, 0x0E1351B8UL, 0x0FD13B8FUL, 0x0D9785D6UL, 0x0C55EFE1UL, \
+    0x091AF964UL, 0x08D89353UL, 0x0A9E2D0AUL, 0x0B5C473DUL, 0x1C26A370UL, 0x1DE4C947UL, \
+    0x1FA2771EUL, 0x1E601D29UL, 0x1B2F0BACUL, 0x1AED619BUL, 0x18ABDFC2UL, 0x1969B5F5UL, \
+    0x1235F2C8UL, 0x13F798FFUL, 0x11B126A6UL, 0x10734C91UL, 0x153C5A14UL, 0x14FE3023UL, \
+    0x16B88E7AUL, 0x177AE44DUL, 0x384D46E0UL, 0x398F2CD7UL, 0x3BC9928EUL, 0x3A0BF8B9UL, \
+    0x3F44EE3CUL, 0x3E86840BUL, 0x3CC03A52UL, 0x3D025065UL, 0x365E1758UL, 0x379C7D6FUL, \
+    0x35DAC336UL, 0x3418A901UL, 0x3157BF84UL, 0x3095D5B3UL, 0x32D36BEAUL, 0x331101DDUL, \
+    0x246BE590UL, 0x25A98FA7UL, 0x27EF31FEUL, 0x262D5BC9UL, 0x23624D4CUL, 0x22A0277BUL, \
+    0x20E69922UL, 0x2124F315UL, 0x2A78B428UL, 0x2BBADE1FUL, 0x29FC6046UL, 0x283E0A71UL, \
+    0x2D711CF4UL, 0x2CB376C3UL, 0x2EF5C89AUL, 0x2F37A2ADUL, 0x709A8DC0UL, 0x7158E7F7UL, \
+    0x731E59AEUL, 0x72DC3399UL, 0x7793251CUL, 0x76514F2BUL, 0x7417F172UL, 0x75D59B45UL, \
+    0x7E89DC78UL, 0x7F4BB64FUL, 0x7D0D0816UL, 0x7CCF6221UL, 0x798074A4UL, 0x78421E93UL, \
+    0x7A04A0CAUL, 0x7BC6CAFDUL, 0x6CBC2EB0UL, 0x6D7E4487UL, 0x6F38FADEUL, 0x6EFA90E9UL, \
+    0x6BB5866CUL, 0x6A77EC5BUL, 0x68315202UL, 0x69F33835UL, 0x62AF7F08UL, 0x636D153FUL, \
+    0x612BAB66UL, 0x60E9C151UL, 0x65A6D7D4UL, 0x6464BDE3UL, 0x662203BAUL, 0x67E0698DUL, \
+    0x48D7CB20UL, 0x4915A117UL, 0x4B531F4EUL, 0x4A917579UL, 0x4FDE63FCUL, 0x4E1C09CBUL, \
+    0x4C5AB792UL, 0x4D98DDA5UL, 0x46C49A98UL, 0x4706F0AFUL, 0x45404EF6UL, 0x448224C1UL, \
+    0x41CD3244UL, 0x400F5873UL, 0x4249E62AUL, 0x438B8C1DUL, 0x54F16850UL, 0x55330267UL, \
+    0x5775BC3EUL, 0x56B7D609UL, 0x53F8C08CUL, 0x523AAABBUL, 0x507C14E2UL, 0x51BE7ED5UL, \
+    0x5AE239E8UL, 0x5B2053DFUL, 0x5966ED86UL, 0x58A487B1UL, 0x5DEB9134UL, 0x5C29FB03UL, \
+    0x5E6F455AUL, 0x5FAD2F6DUL, 0xE1351B80UL, 0xE0F771B7UL, 0xE2B1CFEEUL, 0xE373A5D9UL, \
+    0xE63CB35CUL, 0xE7FED96BUL, 0xE5B86732UL, 0xE47A0D05UL, 0xEF264A38UL, 0xEEE4200FUL, \
+    0xECA29E56UL, 0xED60F461UL, 0xE82FE2E4UL, 0xE9ED88D3UL, 0xEBAB368AUL, 0xEA695CBDUL, \
+    0xFD13B8F0UL, 0xFCD1D2C7UL, 0xFE976C9EUL, 0xFF5506A9UL, 0xFA1A102CUL, 0xFBD87A1BUL, \
+    0xF99EC442UL, 0xF85CAE75UL, 0xF300E948UL, 0xF2C2837FUL, 0xF0843D26UL, 0xF1465711UL, \
+    0xF4094194UL, 0xF5CB2BA3UL, 0xF78D95FAUL, 0xF64FFFCDUL, 0xD9785D60UL, 0xD8BA3757UL, \
+    0xDAFC890EUL, 0xDB3EE339UL, 0xDE71F5BCUL, 0xDFB39F8BUL, 0xDDF521D2UL, 0xDC374BE5UL, \
+    0xD76B0CD8UL, 0xD6A966EFUL, 0xD4EFD8B6UL, 0xD52DB281UL, 0xD062A404UL, 0xD1A0CE33UL, \
+    0xD3E6706AUL, 0xD2241A5DUL, 0xC55EFE10UL, 0xC49C9427UL, 0xC6DA2A7EUL, 0xC7184049UL, \
+    0xC25756CCUL, 0xC3953CFBUL, 0xC1D382A2UL, 0xC011E895UL, 0xCB4DAFA8UL, 0xCA8FC59FUL, \
+    0xC8C97BC6UL, 0xC90B11F1UL, 0xCC440774UL, 0xCD866D43UL, 0xCFC0D31AUL, 0xCE02B92DUL, \
+    0x91AF9640UL, 0x906DFC77UL, 0x922B422EUL, 0x93E92819UL, 0x96A63E9CUL, 0x976454ABUL, \
+    0x9522EAF2UL, 0x94E080C5UL, 0x9FBCC7F8UL, 0x9E7EADCFUL, 0x9C381396UL, 0x9DFA79A1UL, \
+    0x98B56F24UL, 0x99770513UL, 0x9B31BB4AUL, 0x9AF3D17DUL, 0x8D893530UL, 0x8C4B5F07UL, \
+    0x8E0DE15EUL, 0x8FCF8B69UL, 0x8A809DECUL, 0x8B42F7DBUL, 0x89044982UL, 0x88C623B5UL, \
+    0x839A6488UL, 0x82580EBFUL, 0x801EB0E6UL, 0x81DCDAD1UL, 0x8493CC54UL, 0x8551A663UL, \
+    0x8717183AUL, 0x86D5720DUL, 0xA9E2D0A0UL, 0xA820BA97UL, 0xAA6604CEUL, 0xABA46EF9UL, \
+    0xAEEB787CUL, 0xAF29124BUL, 0xAD6FAC12UL, 0xACADC625UL, 0xA7F18118UL, 0xA633EB2FUL, \
+    0xA4755576UL, 0xA5B73F41UL, 0xA0F829C4UL, 0xA13A43F3UL, 0xA37CFDAAUL, 0xA2BE979DUL, \
+    0xB5C473D0UL, 0xB40619E7UL, 0xB640A7BEUL, 0xB782CD89UL, 0xB2CDDB0CUL, 0xB30FB13BUL, \
+    0xB1490F62UL, 0xB08B6555UL, 0xBBD72268UL, 0xBA15485FUL, 0xB853F606UL, 0xB9919C31UL, \
+    0xBCDE8AB4UL, 0xBD1CE083UL, 0xBF5A5EDAUL, 0xBE9834EDUL
+
+#define CRC32_TABLE3 \
+    0x00000000UL, 0xB8BC6765UL, 0xAA09C88BUL, 0x12B5AFEEUL, 0x8F629757UL, 0x37DEF032UL, \
+    0x256B5FDCUL, 0x9DD738B9UL, 0xC5B428EFUL, 0x7D084F8AUL, 0x6FBDE064UL, 0xD7018701UL, \
+    0x4AD6BFB8UL, 0xF26AD8DDUL, 0xE0DF7733UL, 0x58631056UL, 0x5019579FUL, 0xE8A530FAUL, \
+    0xFA109F14UL, 0x42ACF871UL, 0xDF7BC0C8UL, 0x67C7A7ADUL, 0x75720843UL, 0xCDCE6F26UL, \
+    0x95AD7F70UL, 0x2D111815UL, 0x3FA4B7FBUL, 0x8718D09EUL, 0x1ACFE827UL, 0xA2738F42UL, \
+    0xB0C620ACUL, 0x087A47C9UL, 0xA032AF3EUL, 0x188EC85BUL, 0x0A3B67B5UL, 0xB28700D0UL, \
+    0x2F503869UL, 0x97EC5F0CUL, 0x8559F0E2UL, 0x3DE59787UL, 0x658687D1UL, 0xDD3AE0B4UL, \
+    0xCF8F4F5AUL, 0x7733283FUL, 0xEAE41086UL, 0x525877E3UL, 0x40EDD80DUL, 0xF851BF68UL, \
+    0xF02BF8A1UL, 0x48979FC4UL, 0x5A22302AUL, 0xE29E574FUL, 0x7F496FF6UL, 0xC7F50893UL, \
+    0xD540A77DUL, 0x6DFCC018UL, 0x359FD04EUL, 0x8D23B72BUL, 0x9F9618C5UL, 0x272A7FA0UL, \
+    0xBAFD4719UL, 0x0241207CUL, 0x10F48F92UL, 0xA848E8F7UL, 0x9B14583DUL, 0x23A83F58UL, \
+    0x311D90B6UL, 0x89A1F7D3UL, 0x1476CF6AUL, 0xACCAA80FUL, 0xBE7F07E1UL, 0x06C36084UL, \
+    0x5EA070D2UL, 0xE61C17B7UL, 0xF4A9B859UL, 0x4C15DF3CUL, 0xD1C2E785UL, 0x697E80E0UL, \
+    0x7BCB2F0EUL, 0xC377486BUL, 0xCB0D0FA2UL, 0x73B168C7UL, 0x6104C729UL, 0xD9B8A04CUL, \
+    0x446F98F5UL, 0xFCD3FF90UL, 0xEE66507EUL, 0x56DA371BUL, 0x0EB9274DUL, 0xB6054028UL, \
+    0xA4B0EFC6UL, 0x1C0C88A3UL, 0x81DBB01AUL, 0x3967D77FUL, 0x2BD27891UL, 0x936E1FF4UL, \
+    0x3B26F703UL, 0x839A9066UL, 0x912F3F88UL, 0x299358EDUL, 0xB4446054UL, 0x0CF80731UL, \
+    0x1E4DA8DFUL, 0xA6F1CFBAUL, 0xFE92DFECUL, 0x462EB889UL, 0x549B1767UL, 0xEC277002UL, \
+    0x71F048BBUL, 0xC94C2FDEUL, 0xDBF98030UL, 0x6345E755UL, 0x6B3FA09CUL, 0xD383C7F9UL, \
+    0xC1366817UL, 0x798A0F72UL, 0xE45D37CBUL, 0x5CE150AEUL, 0x4E54FF40UL, 0xF6E89825UL, \
+    0xAE8B8873UL, 0x1637EF16UL, 0x048240F8UL, 0xBC3E279DUL, 0x21E91F24UL, 0x99557841UL, \
+    0x8BE0D7AFUL, 0x335CB0CAUL, 0xED59B63BUL, 0x55E5D15EUL, 0x47507EB0UL, 0xFFEC19D5UL, \
+    0x623B216CUL, 0xDA874609UL, 0xC832E9E7UL, 0x708E8E82UL, 0x28ED9ED4UL, 0x9051F9B1UL, \
+    0x82E4565FUL, 0x3A58313AUL, 0xA78F0983UL, 0x1F336EE6UL, 0x0D86C108UL, 0xB53AA66DUL, \
+    0xBD40E1A4UL, 0x05FC86C1UL, 0x1749292FUL, 0xAFF54E4AUL, 0x322276F3UL, 0x8A9E1196UL, \
+    0x982BBE78UL, 0x2097D91DUL, 0x78F4C94BUL, 0xC048AE2EUL, 0xD2FD01C0UL, 0x6A4166A5UL, \
+    0xF7965E1CUL, 0x4F2A3979UL, 0x5D9F9697UL, 0xE523F1F2UL, 0x4D6B1905UL, 0xF5D77E60UL, \
+    0xE762D18EUL, 0x5FDEB6EBUL, 0xC2098E52UL, 0x7AB5E937UL, 0x680046D9UL, 0xD0BC21BCUL, \
+    0x88DF31EAUL, 0x3063568FUL, 0x22D6F961UL, 0x9A6A9E04UL, 0x07BDA6BDUL, 0xBF01C1D8UL, \
+    0xADB46E36UL, 0x15080953UL, 0x1D724E9AUL, 0xA5CE29FFUL, 0xB77B8611UL, 0x0FC7E174UL, \
+    0x9210D9CDUL, 0x2AACBEA8UL, 0x38191146UL, 0x80A57623UL, 0xD8C66675UL, 0x607A0110UL, \
+    0x72CFAEFEUL, 0xCA73C99BUL, 0x57A4F122UL, 0xEF189647UL, 0xFDAD39A9UL, 0x45115ECCUL, \
+    0x764DEE06UL, 0xCEF18963UL, 0xDC44268DUL, 0x64F841E8UL, 0xF92F7951UL, 0x41931E34UL, \
+    0x5326B1DAUL, 0xEB9AD6BFUL, 0xB3F9C6E9UL, 0x0B45A18CUL, 0x19F00E62UL, 0xA14C6907UL, \
+    0x3C9B51BEUL, 0x842736DBUL, 0x96929935UL, 0x2E2EFE50UL, 0x2654B999UL, 0x9EE8DEFCUL, \
+    0x8C5D7112UL, 0x34E11677UL, 0xA9362ECEUL, 0x118A49ABUL, 0x033FE645UL, 0xBB838120UL, \
+    0xE3E09176UL, 0x5B5CF613UL, 0x49E959FDUL, 0xF1553E98UL, 0x6C820621UL, 0xD43E6144UL, \
+    0xC68BCEAAUL, 0x7E37A9CFUL, 0xD67F4138UL, 0x6EC3265DUL, 0x7C7689B3UL, 0xC4CAEED6UL, \
+    0x591DD66FUL, 0xE1A1B10AUL, 0xF3141EE4UL, 0x4BA87981UL, 0x13CB69D7UL, 0xAB770EB2UL, \
+    0xB9C2A15CUL, 0x017EC639UL, 0x9CA9FE80UL, 0x241599E5UL, 0x36A0360BUL, 0x8E1C516EUL, \
+    0x866616A7UL, 0x3EDA71C2UL, 0x2C6FDE2CUL, 0x94D3B949UL, 0x090481F0UL, 0xB1B8E695UL, \
+    0xA30D497BUL, 0x1BB12E1EUL, 0x43D23E48UL, 0xFB6E592DUL, 0xE9DBF6C3UL, 0x516791A6UL, \
+    0xCCB0A91FUL, 0x740CCE7AUL, 0x66B96194UL, 0xDE0506F1UL
+
+#define CRC32_NIBBLE \
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL, 0x76DC4190UL, 0x6B6B51F4UL, \
+    0x4DB26158UL, 0x5005713CUL, 0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL, \
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+
+#define CRC64_TABLE0 \
+    0x0000000000000000ULL, 0x7AD870C830358979ULL, 0xF5B0E190606B12F2ULL, 0x8F689158505E9B8BULL, \
+    0xC038E5739841B68FULL, 0xBAE095BBA8743FF6ULL, 0x358804E3F82AA47DULL, 0x4F50742BC81F2D04ULL, \
+    0xAB28ECB46814FE75ULL, 0xD1F09C7C5821770CULL, 0x5E980D24087FEC87ULL, 0x24407DEC384A65FEULL, \
+    0x6B1009C7F05548FAULL, 0x11C8790FC060C183ULL, 0x9EA0E857903E5A08ULL, 0xE478989FA00BD371ULL, \
+    0x7D08FF3B88BE6F81ULL, 0x07D08FF3B88BE6F8ULL, 0x88B81EABE8D57D73ULL, 0xF2606E63D8E0F40AULL, \
+    0xBD301A4810FFD90EULL, 0xC7E86A8020CA5077ULL, 0x4880FBD87094CBFCULL, 0x32588B1040A14285ULL, \
+    0xD620138FE0AA91F4ULL, 0xACF86347D09F188DULL, 0x2390F21F80C18306ULL, 0x594882D7B0F40A7FULL, \
+    0x1618F6FC78EB277BULL, 0x6CC0863448DEAE02ULL, 0xE3A8176C18803589ULL, 0x997067A428B5BCF0ULL, \
+    0xFA11FE77117CDF02ULL, 0x80C98EBF2149567BULL, 0x0FA11FE77117CDF0ULL, 0x75796F2F41224489ULL, \
+    0x3A291B04893D698DULL, 0x40F16BCCB908E0F4ULL, 0xCF99FA94E9567B7FULL, 0xB5418A5CD963F206ULL, \
+    0x513912C379682177ULL, 0x2BE1620B495DA80EULL, 0xA489F35319033385ULL, 0xDE51839B2936BAFCULL, \
+    0x9101F7B0E12997F8ULL, 0xEBD98778D11C1E81ULL, 0x64B116208142850AULL, 0x1E6966E8B1770C73ULL, \
+    0x8719014C99C2B083ULL, 0xFDC17184A9F739FAULL, 0x72A9E0DCF9A9A271ULL, 0x08719014C99C2B08ULL, \
+    0x4721E43F0183060CULL, 0x3DF994F731B68F75ULL, 0xB29105AF61E814FEULL, 0xC849756751DD9D87ULL, \
+    0x2C31EDF8F1D64EF6ULL, 0x56E99D30C1E3C78FULL, 0xD9810C6891BD5C04ULL, 0xA3597CA0A188D57DULL, \
+    0xEC09088B6997F879ULL, 0x96D1784359A27100ULL, 0x19B9E91B09FCEA8BULL, 0x636199D339C963F2ULL, \
+    0xDF7ADABD7A6E2D6FULL, 0xA5A2AA754A5BA416ULL, 0x2ACA3B2D1A053F9DULL, 0x50124BE52A30B6E4ULL, \
+    0x1F423FCEE22F9BE0ULL, 0x659A4F06D21A1299ULL, 0xEAF2DE5E82448912ULL, 0x902AAE96B271006BULL, \
+    0x74523609127AD31AULL, 0x0E8A46C1224F5A63ULL, 0x81E2D7997211C1E8ULL, 0xFB3AA75142244891ULL, \
+    0xB46AD37A8A3B6595ULL, 0xCEB2A3B2BA0EECECULL, 0x41DA32EAEA507767ULL, 0x3B024222DA65FE1EULL, \
+    0xA2722586F2D042EEULL, 0xD8AA554EC2E5CB97ULL, 0x57C2C41692BB501CULL, 0x2D1AB4DEA28ED965ULL, \
+    0x624AC0F56A91F461ULL, 0x1892B03D5AA47D18ULL, 0x97FA21650AFAE693ULL, 0xED2251AD3ACF6FEAULL, \
+    0x095AC9329AC4BC9BULL, 0x7382B9FAAAF135E2ULL, 0xFCEA28A2FAAFAE69ULL, 0x8632586ACA9A2710ULL, \
+    0xC9622C4102850A14ULL, 0xB3BA5C8932B0836DULL, 0x3CD2CDD162EE18E6ULL, 0x460ABD1952DB919FULL, \
+    0x256B24CA6B12F26DULL, 0x5FB354025B277B14ULL, 0xD0DBC55A0B79E09FULL, 0xAA03B5923B4C69E6ULL, \
+    0xE553C1B9F35344E2ULL, 0x9F8BB171C366CD9BULL, 0x10E3202993385610ULL, 0x6A3B50E1A30DDF69ULL, \
+    0x8E43C87E03060C18ULL, 0xF49BB8B633338561ULL, 0x7BF329EE636D1EEAULL, 0x012B592653589793ULL, \
+    0x4E7B2D0D9B47BA97ULL, 0x34A35DC5AB7233EEULL, 0xBBCBCC9DFB2CA865ULL, 0xC113BC55CB19211CULL, \
+    0x5863DBF1E3AC9DECULL, 0x22BBAB39D3991495ULL, 0xADD33A6183C78F1EULL, 0xD70B4AA9B3F20667ULL, \
+    0x985B3E827BED2B63ULL, 0xE2834E4A4BD8A21AULL, 0x6DEBDF121B863991ULL, 0x1733AFDA2BB3B0E8ULL, \
+    0xF34B37458BB86399ULL, 0x8993478DBB8DEAE0ULL, 0x06FBD6D5EBD3716BULL, 0x7C23A61DDBE6F812ULL, \
+    0x3373D23613F9D516ULL, 0x49ABA2FE23CC5C6FULL, 0xC6C333A67392C7E4ULL, 0xBC1B436E43A74E9DULL, \
+    0x95AC9329AC4BC9B5ULL, 0xEF74E3E19C7E40CCULL, 0x601C72B9CC20DB47ULL, 0x1AC40271FC15523EULL, \
+    0x5594765A340A7F3AULL, 0x2F4C0692043FF643ULL, 0xA02497CA54616DC8ULL, 0xDAFCE7026454E4B1ULL, \
+    0x3E847F9DC45F37C0ULL, 0x445C0F55F46ABEB9ULL, 0xCB349E0DA4342532ULL, 0xB1ECEEC59401AC4BULL, \
+    0xFEBC9AEE5C1E814FULL, 0x8464EA266C2B0836ULL, 0x0B0C7B7E3C7593BDULL, 0x71D40BB60C401AC4ULL, \
+    0xE8A46C1224F5A634ULL, 0x927C1CDA14C02F4DULL, 0x1D148D82449EB4C6ULL, 0x67CCFD4A74AB3DBFULL, \
+    0x289C8961BCB410BBULL, 0x5244F9A98C8199C2ULL, 0xDD2C68F1DCDF0249ULL, 0xA7F41839ECEA8B30ULL, \
+    0x438C80A64CE15841ULL, 0x3954F06E7CD4D138ULL, 0xB63C61362C8A4AB3ULL, 0xCCE411FE1CBFC3CAULL, \
+    0x83B465D5D4A0EECEULL, 0xF96C151DE49567B7ULL, 0x76048445B4CBFC3CULL, 0x0CDCF48D84FE7545ULL, \
+    0x6FBD6D5EBD3716B7ULL, 0x15651D968D029FCEULL, 0x9A0D8CCEDD5C0445ULL, 0xE0D5FC06ED698D3CULL, \
+    0xAF85882D2576A038ULL, 0xD55DF8E515432941ULL, 0x5A3569BD451DB2CAULL, 0x20ED197575283BB3ULL, \
+    0xC49581EAD523E8C2ULL, 0xBE4DF122E51661BBULL, 0x3125607AB548FA30ULL, 0x4BFD10B2857D7349ULL, \
+    0x04AD64994D625E4DULL, 0x7E7514517D57D734ULL, 0xF11D85092D094CBFULL, 0x8BC5F5C11D3CC5C6ULL, \
+    0x12B5926535897936ULL, 0x686DE2AD05BCF04FULL, 0xE70573F555E26BC4ULL, 0x9DDD033D65D7E2BDULL, \
+    0xD28D7716ADC8CFB9ULL, 0xA85507DE9DFD46C0ULL, 0x273D9686CDA3DD4BULL, 0x5DE5E64EFD965432ULL, \
+    0xB99D7ED15D9D8743ULL, 0xC3450E196DA80E3AULL, 0x4C2D9F413DF695B1ULL, 0x36F5EF890DC31CC8ULL, \
+    0x79A59BA2C5DC31CCULL, 0x037DEB6AF5E9B8B5ULL, 0x8C157A32A5B7233EULL, 0xF6CD0AFA9582AA47ULL, \
+    0x4AD64994D625E4DAULL, 0x300E395CE6106DA3ULL, 0xBF66A804B64EF628ULL, 0xC5BED8CC867B7F51ULL, \
+    0x8AEEACE74E645255ULL, 0xF036DC2F7E51DB2CULL, 0x7F5E4D772E0F40A7ULL, 0x05863DBF1E3AC9DEULL, \
+    0xE1FEA520BE311AAFULL, 0x9B26D5E88E0493D6ULL, 0x144E44B0DE5A085DULL, 0x6E963478EE6F8124ULL, \
+    0x21C640532670AC20ULL, 0x5B1E309B16452559ULL, 0xD476A1C3461BBED2ULL, 0xAEAED10B762E37ABULL, \
+    0x37DEB6AF5E9B8B5BULL, 0x4D06C6676EAE0222ULL, 0xC26E573F3EF099A9ULL, 0xB8B627F70EC510D0ULL, \
+    0xF7E653DCC6DA3DD4ULL, 0x8D3E2314F6EFB4ADULL, 0x0256B24CA6B12F26ULL, 0x788EC2849684A65FULL, \
+    0x9CF65A1B368F752EULL, 0xE62E2AD306BAFC57ULL, 0x6946BB8B56E467DCULL, 0x139ECB4366D1EEA5ULL, \
+    0x5CCEBF68AECEC3A1ULL, 0x2616CFA09EFB4AD8ULL, 0xA97E5EF8CEA5D153ULL, 0xD3A62E30FE90582AULL, \
+    0xB0C7B7E3C7593BD8ULL, 0xCA1FC72BF76CB2A1ULL, 0x45775673A732292AULL, 0x3FAF26BB9707A053ULL, \
+    0x70FF52905F188D57ULL, 0x0A2722586F2D042EULL, 0x854FB3003F739FA5ULL, 0xFF97C3C80F4616DCULL, \
+    0x1BEF5B57AF4DC5ADULL, 0x61372B9F9F784CD4ULL, 0xEE5FBAC7CF26D75FULL, 0x9487CA0FFF135E26ULL, \
+    0xDBD7BE24370C7322ULL, 0xA10FCEEC0739FA5BULL, 0x2E675FB4576761D0ULL, 0x54BF2F7C6752E8A9ULL, \
+    0xCDCF48D84FE75459ULL, 0xB71738107FD2DD20ULL, 0x387FA9482F8C46ABULL, 0x42A7D9801FB9CFD2ULL, \
+    0x0DF7ADABD7A6E2D6ULL, 0x772FDD63E7936BAFULL, 0xF8474C3BB7CDF024ULL, 0x829F3CF387F8795DULL, \
+    0x66E7A46C27F3AA2CULL, 0x1C3FD4A417C62355ULL, 0x935745FC4798B8DEULL, 0xE98F353477AD31A7ULL, \
+    0xA6DF411FBFB21CA3ULL, 0xDC0731D78F8795DAULL, 0x536FA08FDFD90E51ULL, 0x29B7D047EFEC8728ULL
+
+#define CRC64_TABLE1 \
+    0x0000000000000000ULL, 0x89E99FFD73BDDF69ULL, 0x388A19A9BFEC2DB9ULL, 0xB1638654CC51F2D0ULL, \
+    0x711433537FD85B72ULL, 0xF8FDACAE0C65841BULL, 0x499E2AFAC03476CBULL, 0xC077B507B389A9A2ULL, \
+    0xE22866A6FFB0B6E4ULL, 0x6BC1F95B8C0D698DULL, 0xDAA27F0F405C9B5DULL, 0x534BE0F233E14434ULL, \
+    0x933C55F58068ED96ULL, 0x1AD5CA08F3D532FFULL, 0xABB64C5C3F84C02FULL, 0x225FD3A14C391F46ULL, \
+    0xEF09EB1EA7F6FEA3ULL, 0x66E074E3D44B21CAULL, 0xD783F2B7181AD31AULL, 0x5E6A6D4A6BA70C73ULL, \
+    0x9E1DD84DD82EA5D1ULL, 0x17F447B0AB937AB8ULL, 0xA697C1E467C28868ULL, 0x2F7E5E19147F5701ULL, \
+    0x0D218DB858464847ULL, 0x84C812452BFB972EULL, 0x35AB9411E7AA65FEULL, 0xBC420BEC9417BA97ULL, \
+    0x7C35BEEB279E1335ULL, 0xF5DC21165423CC5CULL, 0x44BFA74298723E8CULL, 0xCD5638BFEBCFE1E5ULL, \
+    0xF54AF06E177A6E2DULL, 0x7CA36F9364C7B144ULL, 0xCDC0E9C7A8964394ULL, 0x4429763ADB2B9CFDULL, \
+    0x845EC33D68A2355FULL, 0x0DB75CC01B1FEA36ULL, 0xBCD4DA94D74E18E6ULL, 0x353D4569A4F3C78FULL, \
+    0x176296C8E8CAD8C9ULL, 0x9E8B09359B7707A0ULL, 0x2FE88F615726F570ULL, 0xA601109C249B2A19ULL, \
+    0x6676A59B971283BBULL, 0xEF9F3A66E4AF5CD2ULL, 0x5EFCBC3228FEAE02ULL, 0xD71523CF5B43716BULL, \
+    0x1A431B70B08C908EULL, 0x93AA848DC3314FE7ULL, 0x22C902D90F60BD37ULL, 0xAB209D247CDD625EULL, \
+    0x6B572823CF54CBFCULL, 0xE2BEB7DEBCE91495ULL, 0x53DD318A70B8E645ULL, 0xDA34AE770305392CULL, \
+    0xF86B7DD64F3C266AULL, 0x7182E22B3C81F903ULL, 0xC0E1647FF0D00BD3ULL, 0x4908FB82836DD4BAULL, \
+    0x897F4E8530E47D18ULL, 0x0096D1784359A271ULL, 0xB1F5572C8F0850A1ULL, 0x381CC8D1FCB58FC8ULL, \
+    0xC1CCC68F76634F31ULL, 0x4825597205DE9058ULL, 0xF946DF26C98F6288ULL, 0x70AF40DBBA32BDE1ULL, \
+    0xB0D8F5DC09BB1443ULL, 0x39316A217A06CB2AULL, 0x8852EC75B65739FAULL, 0x01BB7388C5EAE693ULL, \
+    0x23E4A02989D3F9D5ULL, 0xAA0D3FD4FA6E26BCULL, 0x1B6EB980363FD46CULL, 0x9287267D45820B05ULL, \
+    0x52F0937AF60BA2A7ULL, 0xDB190C8785B67DCEULL, 0x6A7A8AD349E78F1EULL, 0xE393152E3A5A5077ULL, \
+    0x2EC52D91D195B192ULL, 0xA72CB26CA2286EFBULL, 0x164F34386E799C2BULL, 0x9FA6ABC51DC44342ULL, \
+    0x5FD11EC2AE4DEAE0ULL, 0xD638813FDDF03589ULL, 0x675B076B11A1C759ULL, 0xEEB29896621C1830ULL, \
+    0xCCED4B372E250776ULL, 0x4504D4CA5D98D81FULL, 0xF467529E91C92ACFULL, 0x7D8ECD63E274F5A6ULL, \
+    0xBDF9786451FD5C04ULL, 0x3410E7992240836DULL, 0x857361CDEE1171BDULL, 0x0C9AFE309DACAED4ULL, \
+    0x348636E16119211CULL, 0xBD6FA91C12A4FE75ULL, 0x0C0C2F48DEF50CA5ULL, 0x85E5B0B5AD48D3CCULL, \
+    0x459205B21EC17A6EULL, 0xCC7B9A4F6D7CA507ULL, 0x7D181C1BA12D57D7ULL, 0xF4F183E6D29088BEULL, \
+    0xD6AE50479EA997F8ULL, 0x5F47CFBAED144891ULL, 0xEE2449EE2145BA41ULL, 0x67CDD61352F86528ULL, \
+    0xA7BA6314E171CC8AULL, 0x2E53FCE992CC13E3ULL, 0x9F307ABD5E9DE133ULL, 0x16D9E5402D203E5AULL, \
+    0xDB8FDDFFC6EFDFBFULL, 0x52664202B55200D6ULL, 0xE305C4567903F206ULL, 0x6AEC5BAB0ABE2D6FULL, \
+    0xAA9BEEACB93784CDULL, 0x23727151CA8A5BA4ULL, 0x9211F70506DBA974ULL, 0x1BF868F87566761DULL, \
+    0x39A7BB59395F695BULL, 0xB04E24A44AE2B632ULL, 0x012DA2F086B344E2ULL, 0x88C43D0DF50E9B8BULL, \
+    0x48B3880A46873229ULL, 0xC15A17F7353AED40ULL, 0x703991A3F96B1F90ULL, 0xF9D00E5E8AD6C0F9ULL, \
+    0xA8C0AB4DB4510D09ULL, 0x212934B0C7ECD260ULL, 0x904AB2E40BBD20B0ULL, 0x19A32D197800FFD9ULL, \
+    0xD9D4981ECB89567BULL, 0x503D07E3B8348912ULL, 0xE15E81B774657BC2ULL, 0x68B71E4A07D8A4ABULL, \
+    0x4AE8CDEB4BE1BBEDULL, 0xC3015216385C6484ULL, 0x7262D442F40D9654ULL, 0xFB8B4BBF87B0493DULL, \
+    0x3BFCFEB83439E09FULL, 0xB215614547843FF6ULL, 0x0376E7118BD5CD26ULL, 0x8A9F78ECF868124FULL, \
+    0x47C9405313A7F3AAULL, 0xCE20DFAE601A2CC3ULL, 0x7F4359FAAC4BDE13ULL, 0xF6AAC607DFF6017AULL, \
+    0x36DD73006C7FA8D8ULL, 0xBF34ECFD1FC277B1ULL, 0x0E576AA9D3938561ULL, 0x87BEF554A02E5A08ULL, \
+    0xA5E126F5EC17454EULL, 0x2C08B9089FAA9A27ULL, 0x9D6B3F5C53FB68F7ULL, 0x1482A0A12046B79EULL, \
+    0xD4F515A693CF1E3CULL, 0x5D1C8A5BE072C155ULL, 0xEC7F0C0F2C233385ULL, 0x659693F25F9EECECULL, \
+    0x5D8A5B23A32B6324ULL, 0xD463C4DED096BC4DULL, 0x6500428A1CC74E9DULL, 0xECE9DD776F7A91F4ULL, \
+    0x2C9E6870DCF33856ULL, 0xA577F78DAF4EE73FULL, 0x141471D9631F15EFULL, 0x9DFDEE2410A2CA86ULL, \
+    0xBFA23D855C9BD5C0ULL, 0x364BA2782F260AA9ULL, 0x8728242CE377F879ULL, 0x0EC1BBD190CA2710ULL, \
+    0xCEB60ED623438EB2ULL, 0x475F912B50FE51DBULL, 0xF63C177F9CAFA30BULL, 0x7FD58882EF127C62ULL, \
+    0xB283B03D04DD9D87ULL, 0x3B6A2FC0776042EEULL, 0x8A09A994BB31B03EULL, 0x03E03669C88C6F57ULL, \
+    0xC397836E7B05C6F5ULL, 0x4A7E1C9308B8199CULL, 0xFB1D9AC7C4E9EB4CULL, 0x72F4053AB7543425ULL, \
+    0x50ABD69BFB6D2B63ULL, 0xD942496688D0F40AULL, 0x6821CF32448106DAULL, 0xE1C850CF373CD9B3ULL, \
+    0x21BFE5C884B57011ULL, 0xA8567A35F708AF78ULL, 0x1935FC613B595DA8ULL, 0x90DC639C48E482C1ULL, \
+    0x690C6DC2C2324238ULL, 0xE0E5F23FB18F9D51ULL, 0x5186746B7DDE6F81ULL, 0xD86FEB960E63B0E8ULL, \
+    0x18185E91BDEA194AULL, 0x91F1C16CCE57C623ULL, 0x20924738020634F3ULL, 0xA97BD8C571BBEB9AULL, \
+    0x8B240B643D82F4DCULL, 0x02CD94994E3F2BB5ULL, 0xB3AE12CD826ED965ULL, 0x3A478D30F1D3060CULL, \
+    0xFA303837425AAFAEULL, 0x73D9A7CA31E770C7ULL, 0xC2BA219EFDB68217ULL, 0x4B53BE638E0B5D7EULL, \
+    0x860586DC65C4BC9BULL, 0x0FEC1921167963F2ULL, 0xBE8F9F75DA289122ULL, 0x37660088A9954E4BULL, \
+    0xF711B58F1A1CE7E9ULL, 0x7EF82A7269A13880ULL, 0xCF9BAC26A5F0CA50ULL, 0x467233DBD64D1539ULL, \
+    0x642DE07A9A740A7FULL, 0xEDC47F87E9C9D516ULL, 0x5CA7F9D3259827C6ULL, 0xD54E662E5625F8AFULL, \
+    0x1539D329E5AC510DULL, 0x9CD04CD496118E64ULL, 0x2DB3CA805A407CB4ULL, 0xA45A557D29FDA3DDULL, \
+    0x9C469DACD5482C15ULL, 0x15AF0251A6F5F37CULL, 0xA4CC84056AA401ACULL, 0x2D251BF81919DEC5ULL, \
+    0xED52AEFFAA907767ULL, 0x64BB3102D92DA80EULL, 0xD5D8B756157C5ADEULL, 0x5C3128AB66C185B7ULL, \
+    0x7E6EFB0A2AF89AF1ULL, 0xF78764F759454598ULL, 0x46E4E2A39514B748ULL, 0xCF0D7D5EE6A96821ULL, \
+    0x0F7AC8595520C183ULL, 0x869357A4269D1EEAULL, 0x37F0D1F0EACCEC3AULL, 0xBE194E0D99713353ULL, \
+    0x734F76B272BED2B6ULL, 0xFAA6E94F01030DDFULL, 0x4BC56F1BCD52FF0FULL, 0xC22CF0E6BEEF2066ULL, \
+    0x025B45E10D6689C4ULL, 0x8BB2DA1C7EDB56ADULL, 0x3AD15C48B28AA47DULL, 0xB338C3B5C1377B14ULL, \
+    0x916710148D0E6452ULL, 0x188E8FE9FEB3BB3BULL, 0xA9ED09BD32E249EBULL, 0x20049640415F9682ULL, \
+    0xE0732347F2D63F20ULL, 0x699ABCBA816BE049ULL, 0xD8F93AEE4D3A1299ULL, 0x5110A5133E87CDF0ULL
+
+#define CRC64_TABLE2 \
+    0x0000000000000000ULL, 0xF4125129CE4038BEULL, 0xC37D8400C417E217ULL, 0x376FD5290A57DAA9ULL, \
+    0xADA22E52D0B85745ULL, 0x59B07F7B1EF86FFBULL, 0x6EDFAA5214AFB552ULL, 0x9ACDFB7BDAEF8DECULL, \
+    0x701D7AF6F9E73DE1ULL, 0x840F2BDF37A7055FULL, 0xB360FEF63DF0DFF6ULL, 0x4772AFDFF3B0E748ULL, \
+    0xDDBF54A4295F6AA4ULL, 0x29AD058DE71F521AULL, 0x1EC2D0A4ED4888B3ULL, 0xEAD0818D2308B00DULL, \
+    0xE03AF5EDF3CE7BC2ULL, 0x1428A4C43D8E437CULL, 0x234771ED37D999D5ULL, 0xD75520C4F999A16BULL, \
+    0x4D98DBBF23762C87ULL, 0xB98A8A96ED361439ULL, 0x8EE55FBFE761CE90ULL, 0x7AF70E962921F62EULL, \
+    0x90278F1B0A294623ULL, 0x6435DE32C4697E9DULL, 0x535A0B1BCE3EA434ULL, 0xA7485A32007E9C8AULL, \
+    0x3D85A149DA911166ULL, 0xC997F06014D129D8ULL, 0xFEF825491E86F371ULL, 0x0AEA7460D0C6CBCFULL, \
+    0xEB2CCD88BF0B64EFULL, 0x1F3E9CA1714B5C51ULL, 0x285149887B1C86F8ULL, 0xDC4318A1B55CBE46ULL, \
+    0x468EE3DA6FB333AAULL, 0xB29CB2F3A1F30B14ULL, 0x85F367DAABA4D1BDULL, 0x71E136F365E4E903ULL, \
+    0x9B31B77E46EC590EULL, 0x6F23E65788AC61B0ULL, 0x584C337E82FBBB19ULL, 0xAC5E62574CBB83A7ULL, \
+    0x3693992C96540E4BULL, 0xC281C805581436F5ULL, 0xF5EE1D2C5243EC5CULL, 0x01FC4C059C03D4E2ULL, \
+    0x0B1638654CC51F2DULL, 0xFF04694C82852793ULL, 0xC86BBC6588D2FD3AULL, 0x3C79ED4C4692C584ULL, \
+    0xA6B416379C7D4868ULL, 0x52A6471E523D70D6ULL, 0x65C99237586AAA7FULL, 0x91DBC31E962A92C1ULL, \
+    0x7B0B4293B52222CCULL, 0x8F1913BA7B621A72ULL, 0xB876C6937135C0DBULL, 0x4C6497BABF75F865ULL, \
+    0xD6A96CC1659A7589ULL, 0x22BB3DE8ABDA4D37ULL, 0x15D4E8C1A18D979EULL, 0xE1C6B9E86FCDAF20ULL, \
+    0xFD00BD4226815AB5ULL, 0x0912EC6BE8C1620BULL, 0x3E7D3942E296B8A2ULL, 0xCA6F686B2CD6801CULL, \
+    0x50A29310F6390DF0ULL, 0xA4B0C2393879354EULL, 0x93DF1710322EEFE7ULL, 0x67CD4639FC6ED759ULL, \
+    0x8D1DC7B4DF666754ULL, 0x790F969D11265FEAULL, 0x4E6043B41B718543ULL, 0xBA72129DD531BDFDULL, \
+    0x20BFE9E60FDE3011ULL, 0xD4ADB8CFC19E08AFULL, 0xE3C26DE6CBC9D206ULL, 0x17D03CCF0589EAB8ULL, \
+    0x1D3A48AFD54F2177ULL, 0xE92819861B0F19C9ULL, 0xDE47CCAF1158C360ULL, 0x2A559D86DF18FBDEULL, \
+    0xB09866FD05F77632ULL, 0x448A37D4CBB74E8CULL, 0x73E5E2FDC1E09425ULL, 0x87F7B3D40FA0AC9BULL, \
+    0x6D2732592CA81C96ULL, 0x99356370E2E82428ULL, 0xAE5AB659E8BFFE81ULL, 0x5A48E77026FFC63FULL, \
+    0xC0851C0BFC104BD3ULL, 0x34974D223250736DULL, 0x03F8980B3807A9C4ULL, 0xF7EAC922F647917AULL, \
+    0x162C70CA998A3E5AULL, 0xE23E21E357CA06E4ULL, 0xD551F4CA5D9DDC4DULL, 0x2143A5E393DDE4F3ULL, \
+    0xBB8E5E984932691FULL, 0x4F9C0FB1877251A1ULL, 0x78F3DA988D258B08ULL, 0x8CE18BB14365B3B6ULL, \
+    0x66310A3C606D03BBULL, 0x92235B15AE2D3B05ULL, 0xA54C8E3CA47AE1ACULL, 0x515EDF156A3AD912ULL, \
+    0xCB93246EB0D554FEULL, 0x3F8175477E956C40ULL, 0x08EEA06E74C2B6E9ULL, 0xFCFCF147BA828E57ULL, \
+    0xF61685276A444598ULL, 0x0204D40EA4047D26ULL, 0x356B0127AE53A78FULL, 0xC179500E60139F31ULL, \
+    0x5BB4AB75BAFC12DDULL, 0xAFA6FA5C74BC2A63ULL, 0x98C92F757EEBF0CAULL, 0x6CDB7E5CB0ABC874ULL, \
+    0x860BFFD193A37879ULL, 0x7219AEF85DE340C7ULL, 0x45767BD157B49A6EULL, 0xB1642AF899F4A2D0ULL, \
+    0x2BA9D183431B2F3CULL, 0xDFBB80AA8D5B1782ULL, 0xE8D45583870CCD2BULL, 0x1CC604AA494CF595ULL, \
+    0xD1585CD715952601ULL, 0x254A0DFEDBD51EBFULL, 0x1225D8D7D182C416ULL, 0xE63789FE1FC2FCA8ULL, \
+    0x7CFA7285C52D7144ULL, 0x88E823AC0B6D49FAULL, 0xBF87F685013A9353ULL, 0x4B95A7ACCF7AABEDULL, \
+    0xA1452621EC721BE0ULL, 0x555777082232235EULL, 0x6238A2212865F9F7ULL, 0x962AF308E625C149ULL, \
+    0x0CE708733CCA4CA5ULL, 0xF8F5595AF28A741BULL, 0xCF9A8C73F8DDAEB2ULL, 0x3B88DD5A369D960CULL, \
+    0x3162A93AE65B5DC3ULL, 0xC570F813281B657DULL, 0xF21F2D3A224CBFD4ULL, 0x060D7C13EC0C876AULL, \
+    0x9CC0876836E30A86ULL, 0x68D2D641F8A33238ULL, 0x5FBD0368F2F4E891ULL, 0xABAF52413CB4D02FULL, \
+    0x417FD3CC1FBC6022ULL, 0xB56D82E5D1FC589CULL, 0x820257CCDBAB8235ULL, 0x761006E515EBBA8BULL, \
+    0xECDDFD9ECF043767ULL, 0x18CFACB701440FD9ULL, 0x2FA0799E0B13D570ULL, 0xDBB228B7C553EDCEULL, \
+    0x3A74915FAA9E42EEULL, 0xCE66C07664DE7A50ULL, 0xF909155F6E89A0F9ULL, 0x0D1B4476A0C99847ULL, \
+    0x97D6BF0D7A2615ABULL, 0x63C4EE24B4662D15ULL, 0x54AB3B0DBE31F7BCULL, 0xA0B96A247071CF02ULL, \
+    0x4A69EBA953797F0FULL, 0xBE7BBA809D3947B1ULL, 0x89146FA9976E9D18ULL, 0x7D063E80592EA5A6ULL, \
+    0xE7CBC5FB83C1284AULL, 0x13D994D24D8110F4ULL, 0x24B641FB47D6CA5DULL, 0xD0A410D28996F2E3ULL, \
+    0xDA4E64B25950392CULL, 0x2E5C359B97100192ULL, 0x1933E0B29D47DB3BULL, 0xED21B19B5307E385ULL, \
+    0x77EC4AE089E86E69ULL, 0x83FE1BC947A856D7ULL, 0xB491CEE04DFF8C7EULL, 0x40839FC983BFB4C0ULL, \
+    0xAA531E44A0B704CDULL, 0x5E414F6D6EF73C73ULL, 0x692E9A4464A0E6DAULL, 0x9D3CCB6DAAE0DE64ULL, \
+    0x07F13016700F5388ULL, 0xF3E3613FBE4F6B36ULL, 0xC48CB416B418B19FULL, 0x309EE53F7A588921ULL, \
+    0x2C58E19533147CB4ULL, 0xD84AB0BCFD54440AULL, 0xEF256595F7039EA3ULL, 0x1B3734BC3943A61DULL, \
+    0x81FACFC7E3AC2BF1ULL, 0x75E89EEE2DEC134FULL, 0x42874BC727BBC9E6ULL, 0xB6951AEEE9FBF158ULL, \
+    0x5C459B63CAF34155ULL, 0xA857CA4A04B379EBULL, 0x9F381F630EE4A342ULL, 0x6B2A4E4AC0A49BFCULL, \
+    0xF1E7B5311A4B1610ULL, 0x05F5E418D40B2EAEULL, 0x329A3131DE5CF407ULL, 0xC6886018101CCCB9ULL, \
+    0xCC621478C0DA0776ULL, 0x387045510E9A3FC8ULL, 0x0F1F907804CDE561ULL, 0xFB0DC151CA8DDDDFULL, \
+    0x61C03A2A10625033ULL, 0x95D26B03DE22688DULL, 0xA2BDBE2AD475B224ULL, 0x56AFEF031A358A9AULL, \
+    0xBC7F6E8E393D3A97ULL, 0x486D3FA7F77D0229ULL, 0x7F02EA8EFD2AD880ULL, 0x8B10BBA7336AE03EULL, \
+    0x11DD40DCE9856DD2ULL, 0xE5CF11F527C5556CULL, 0xD2A0C4DC2D928FC5ULL, 0x26B295F5E3D2B77BULL, \
+    0xC7742C1D8C1F185BULL, 0x33667D34425F20E5ULL, 0x0409A81D4808FA4CULL, 0xF01BF9348648C2F2ULL, \
+    0x6AD6024F5CA74F1EULL, 0x9EC4536692E777A0ULL, 0xA9AB864F98B0AD09ULL, 0x5DB9D76656F095B7ULL, \
+    0xB76956EB75F825BAULL, 0x437B07C2BBB81D04ULL, 0x7414D2EBB1EFC7ADULL, 0x800683C27FAFFF13ULL, \
+    0x1ACB78B9A54072FFULL, 0xEED929906B004A41ULL, 0xD9B6FCB9615790E8ULL, 0x2DA4AD90AF17A856ULL, \
+    0x274ED9F07FD16399ULL, 0xD35C88D9B1915B27ULL, 0xE4335DF0BBC6818EULL, 0x10210CD97586B930ULL, \
+    0x8AECF7A2AF6934DCULL, 0x7EFEA68B61290C62ULL, 0x499173A26B7ED6CBULL, 0xBD83228BA53EEE75ULL, \
+    0x5753A30686365E78ULL, 0xA341F22F487666C6ULL, 0x942E27064221BC6FULL, 0x603C762F8C6184D1ULL, \
+    0xFAF18D54568E093DULL, 0x0EE3DC7D98CE3183ULL, 0x398C09549299EB2AULL, 0xCD9E587D5CD9D394ULL
+
+#define CRC64_TABLE3 \
+    0x0000000000000000ULL, 0x8CE168638C796306ULL, 0x329BF69440655567ULL, 0xBE7A9EF7CC1C3661ULL, \
+    0x6537ED2880CAAACEULL, 0xE9D6854B0CB3C9C8ULL, 0x57AC1BBCC0AFFFA9ULL, 0xDB4D73DF4CD69CAFULL, \
+    0xCA6FDA510195559CULL, 0x468EB2328DEC369AULL, 0xF8F42CC541F000FBULL, 0x741544A6CD8963FDULL, \
+    0xAF583779815FFF52ULL, 0x23B95F1A0D269C54ULL, 0x9DC3C1EDC13AAA35ULL, 0x1122A98E4D43C933ULL, \
+    0xBF8692F15BBD3853ULL, 0x3367FA92D7C45B55ULL, 0x8D1D64651BD86D34ULL, 0x01FC0C0697A10E32ULL, \
+    0xDAB17FD9DB77929DULL, 0x565017BA570EF19BULL, 0xE82A894D9B12C7FAULL, 0x64CBE12E176BA4FCULL, \
+    0x75E948A05A286DCFULL, 0xF90820C3D6510EC9ULL, 0x4772BE341A4D38A8ULL, 0xCB93D65796345BAEULL, \
+    0x10DEA588DAE2C701ULL, 0x9C3FCDEB569BA407ULL, 0x2245531C9A879266ULL, 0xAEA43B7F16FEF160ULL, \
+    0x545403B1EFEDE3CDULL, 0xD8B56BD2639480CBULL, 0x66CFF525AF88B6AAULL, 0xEA2E9D4623F1D5ACULL, \
+    0x3163EE996F274903ULL, 0xBD8286FAE35E2A05ULL, 0x03F8180D2F421C64ULL, 0x8F19706EA33B7F62ULL, \
+    0x9E3BD9E0EE78B651ULL, 0x12DAB1836201D557ULL, 0xACA02F74AE1DE336ULL, 0x2041471722648030ULL, \
+    0xFB0C34C86EB21C9FULL, 0x77ED5CABE2CB7F99ULL, 0xC997C25C2ED749F8ULL, 0x4576AA3FA2AE2AFEULL, \
+    0xEBD29140B450DB9EULL, 0x6733F9233829B898ULL, 0xD94967D4F4358EF9ULL, 0x55A80FB7784CEDFFULL, \
+    0x8EE57C68349A7150ULL, 0x0204140BB8E31256ULL, 0xBC7E8AFC74FF2437ULL, 0x309FE29FF8864731ULL, \
+    0x21BD4B11B5C58E02ULL, 0xAD5C237239BCED04ULL, 0x1326BD85F5A0DB65ULL, 0x9FC7D5E679D9B863ULL, \
+    0x448AA639350F24CCULL, 0xC86BCE5AB97647CAULL, 0x761150AD756A71ABULL, 0xFAF038CEF91312ADULL, \
+    0xA8A80763DFDBC79AULL, 0x24496F0053A2A49CULL, 0x9A33F1F79FBE92FDULL, 0x16D2999413C7F1FBULL, \
+    0xCD9FEA4B5F116D54ULL, 0x417E8228D3680E52ULL, 0xFF041CDF1F743833ULL, 0x73E574BC930D5B35ULL, \
+    0x62C7DD32DE4E9206ULL, 0xEE26B5515237F100ULL, 0x505C2BA69E2BC761ULL, 0xDCBD43C51252A467ULL, \
+    0x07F0301A5E8438C8ULL, 0x8B115879D2FD5BCEULL, 0x356BC68E1EE16DAFULL, 0xB98AAEED92980EA9ULL, \
+    0x172E95928466FFC9ULL, 0x9BCFFDF1081F9CCFULL, 0x25B56306C403AAAEULL, 0xA9540B65487AC9A8ULL, \
+    0x721978BA04AC5507ULL, 0xFEF810D988D53601ULL, 0x40828E2E44C90060ULL, 0xCC63E64DC8B06366ULL, \
+    0xDD414FC385F3AA55ULL, 0x51A027A0098AC953ULL, 0xEFDAB957C596FF32ULL, 0x633BD13449EF9C34ULL, \
+    0xB876A2EB0539009BULL, 0x3497CA888940639DULL, 0x8AED547F455C55FCULL, 0x060C3C1CC92536FAULL, \
+    0xFCFC04D230362457ULL, 0x701D6CB1BC4F4751ULL, 0xCE67F24670537130ULL, 0x42869A25FC2A1236ULL, \
+    0x99CBE9FAB0FC8E99ULL, 0x152A81993C85ED9FULL, 0xAB501F6EF099DBFEULL, 0x27B1770D7CE0B8F8ULL, \
+    0x3693DE8331A371CBULL, 0xBA72B6E0BDDA12CDULL, 0x0408281771C624ACULL, 0x88E94074FDBF47AAULL, \
+    0x53A433ABB169DB05ULL, 0xDF455BC83D10B803ULL, 0x613FC53FF10C8E62ULL, 0xEDDEAD5C7D75ED64ULL, \
+    0x437A96236B8B1C04ULL, 0xCF9BFE40E7F27F02ULL, 0x71E160B72BEE4963ULL, 0xFD0008D4A7972A65ULL, \
+    0x264D7B0BEB41B6CAULL, 0xAAAC13686738D5CCULL, 0x14D68D9FAB24E3ADULL, 0x9837E5FC275D80ABULL, \
+    0x89154C726A1E4998ULL, 0x05F42411E6672A9EULL, 0xBB8EBAE62A7B1CFFULL, 0x376FD285A6027FF9ULL, \
+    0xEC22A15AEAD4E356ULL, 0x60C3C93966AD8050ULL, 0xDEB957CEAAB1B631ULL, 0x52583FAD26C8D537ULL, \
+    0x7A092894E7201C5FULL, 0xF6E840F76B597F59ULL, 0x4892DE00A7454938ULL, 0xC473B6632B3C2A3EULL, \
+    0x1F3EC5BC67EAB691ULL, 0x93DFADDFEB93D597ULL, 0x2DA53328278FE3F6ULL, 0xA1445B4BABF680F0ULL, \
+    0xB066F2C5E6B549C3ULL, 0x3C879AA66ACC2AC5ULL, 0x82FD0451A6D01CA4ULL, 0x0E1C6C322AA97FA2ULL, \
+    0xD5511FED667FE30DULL, 0x59B0778EEA06800BULL, 0xE7CAE979261AB66AULL, 0x6B2B811AAA63D56CULL, \
+    0xC58FBA65BC9D240CULL, 0x496ED20630E4470AULL, 0xF7144CF1FCF8716BULL, 0x7BF524927081126DULL, \
+    0xA0B8574D3C578EC2ULL, 0x2C593F2EB02EEDC4ULL, 0x9223A1D97C32DBA5ULL, 0x1EC2C9BAF04BB8A3ULL, \
+    0x0FE06034BD087190ULL, 0x8301085731711296ULL, 0x3D7B96A0FD6D24F7ULL, 0xB19AFEC3711447F1ULL, \
+    0x6AD78D1C3DC2DB5EULL, 0xE636E57FB1BBB858ULL, 0x584C7B887DA78E39ULL, 0xD4AD13EBF1DEED3FULL, \
+    0x2E5D2B2508CDFF92ULL, 0xA2BC434684B49C94ULL, 0x1CC6DDB148A8AAF5ULL, 0x9027B5D2C4D1C9F3ULL, \
+    0x4B6AC60D8807555CULL, 0xC78BAE6E047E365AULL, 0x79F13099C862003BULL, 0xF51058FA441B633DULL, \
+    0xE432F1740958AA0EULL, 0x68D399178521C908ULL, 0xD6A907E0493DFF69ULL, 0x5A486F83C5449C6FULL, \
+    0x81051C5C899200C0ULL, 0x0DE4743F05EB63C6ULL, 0xB39EEAC8C9F755A7ULL, 0x3F7F82AB458E36A1ULL, \
+    0x91DBB9D45370C7C1ULL, 0x1D3AD1B7DF09A4C7ULL, 0xA3404F40131592A6ULL, 0x2FA127239F6CF1A0ULL, \
+    0xF4EC54FCD3BA6D0FULL, 0x780D3C9F5FC30E09ULL, 0xC677A26893DF3868ULL, 0x4A96CA0B1FA65B6EULL, \
+    0x5BB4638552E5925DULL, 0xD7550BE6DE9CF15BULL, 0x692F95111280C73AULL, 0xE5CEFD729EF9A43CULL, \
+    0x3E838EADD22F3893ULL, 0xB262E6CE5E565B95ULL, 0x0C187839924A6DF4ULL, 0x80F9105A1E330EF2ULL, \
+    0xD2A12FF738FBDBC5ULL, 0x5E404794B482B8C3ULL, 0xE03AD963789E8EA2ULL, 0x6CDBB100F4E7EDA4ULL, \
+    0xB796C2DFB831710BULL, 0x3B77AABC3448120DULL, 0x850D344BF854246CULL, 0x09EC5C28742D476AULL, \
+    0x18CEF5A6396E8E59ULL, 0x942F9DC5B517ED5FULL, 0x2A550332790BDB3EULL, 0xA6B46B51F572B838ULL, \
+    0x7DF9188EB9A42497ULL, 0xF11870ED35DD4791ULL, 0x4F62EE1AF9C171F0ULL, 0xC383867975B812F6ULL, \
+    0x6D27BD066346E396ULL, 0xE1C6D565EF3F8090ULL, 0x5FBC4B922323B6F1ULL, 0xD35D23F1AF5AD5F7ULL, \
+    0x0810502EE38C4958ULL, 0x84F1384D6FF52A5EULL, 0x3A8BA6BAA3E91C3FULL, 0xB66ACED92F907F39ULL, \
+    0xA748675762D3B60AULL, 0x2BA90F34EEAAD50CULL, 0x95D391C322B6E36DULL, 0x1932F9A0AECF806BULL, \
+    0xC27F8A7FE2191CC4ULL, 0x4E9EE21C6E607FC2ULL, 0xF0E47CEBA27C49A3ULL, 0x7C0514882E052AA5ULL, \
+    0x86F52C46D7163808ULL, 0x0A1444255B6F5B0EULL, 0xB46EDAD297736D6FULL, 0x388FB2B11B0A0E69ULL, \
+    0xE3C2C16E57DC92C6ULL, 0x6F23A90DDBA5F1C0ULL, 0xD15937FA17B9C7A1ULL, 0x5DB85F999BC0A4A7ULL, \
+    0x4C9AF617D6836D94ULL, 0xC07B9E745AFA0E92ULL, 0x7E01008396E638F3ULL, 0xF2E068E01A9F5BF5ULL, \
+    0x29AD1B3F5649C75AULL, 0xA54C735CDA30A45CULL, 0x1B36EDAB162C923DULL, 0x97D785C89A55F13BULL, \
+    0x3973BEB78CAB005BULL, 0xB592D6D400D2635DULL, 0x0BE84823CCCE553CULL, 0x8709204040B7363AULL, \
+    0x5C44539F0C61AA95ULL, 0xD0A53BFC8018C993ULL, 0x6EDFA50B4C04FFF2ULL, 0xE23ECD68C07D9CF4ULL, \
+    0xF31C64E68D3E55C7ULL, 0x7FFD0C85014736C1ULL, 0xC1879272CD5B00A0ULL, 0x4D66FA11412263A6ULL, \
+    0x962B89CE0DF4FF09ULL, 0x1ACAE1AD818D9C0FULL, 0xA4B07F5A4D91AA6EULL, 0x28511739C1E8C968ULL
+
+#define CRC64_NIBBLE \
+    0x0000000000000000ULL, 0x7D08FF3B88BE6F81ULL, 0xFA11FE77117CDF02ULL, 0x8719014C99C2B083ULL, \
+    0xDF7ADABD7A6E2D6FULL, 0xA2722586F2D042EEULL, 0x256B24CA6B12F26DULL, 0x5863DBF1E3AC9DECULL, \
+    0x95AC9329AC4BC9B5ULL, 0xE8A46C1224F5A634ULL, 0x6FBD6D5EBD3716B7ULL, 0x12B5926535897936ULL, \
+    0x4AD64994D625E4DAULL, 0x37DEB6AF5E9B8B5BULL, 0xB0C7B7E3C7593BD8ULL, 0xCDCF48D84FE75459ULL
+
+#endif
@@ -46,14 +46,20 @@
 #define DFU_CIPHER_CFB      3   /* Cipher Feedback (CFB) */
 #define DFU_CIPHER_OFB      4   /* Output Feedback (OFB) */
 #define DFU_CIPHER_CTR      5   /* Counter (CTR) */
+/** Authenticated mode for using with CHACHA stream cipher */
+#define DFU_CIPHER_AEAD     6   /* ChaCha20-Poly1305, 128-bit tag for every DFU block */
 
 /** Checksum definitions. */
-#define CRC32FAST           1   /* Lookup table based crc32 algorithm, consumes 1Kb of RAM for the table */
+#define CRC32FAST           1   /* Lookup table based crc32 algorithm, 1Kb table in ROM */
 #define CRC32SMALL          2   /* Permutation based crc32 algorithm, no lookup table required but slower */
 #define FNV1A32             3   /* Fowler–Noll–Vo 32 bit Hash */
 #define FNV1A64             4   /* Fowler–Noll–Vo 64 bit Hash */
-#define CRC64FAST           5   /* Lookup table based crc64 algorithm, consumes 2Kb of RAM for the table */
+#define CRC64FAST           5   /* Lookup table based crc64 algorithm, 2Kb table in ROM */
 #define CRC64SMALL          6   /* Permutation based crc32 algorithm, no lookup table required but extremly slow */
+#define CRC32SLICE4         7   /* Slice-by-4 crc32 algorithm, 4Kb tables in ROM */
+#define CRC64SLICE4         8   /* Slice-by-4 crc64 algorithm, 8Kb tables in ROM */
+#define CRC32NIBBLE         9   /* Nibble table crc32 algorithm, 64 bytes table in ROM */
+#define CRC64NIBBLE         10  /* Nibble table crc64 algorithm, 128 bytes table in ROM */
 
 #define __STR(x) #x
 #define STR(x) __STR(x)
@@ -67,6 +73,50 @@
 #ifndef DFU_DNLOAD_NOSYNC
 #define DFU_DNLOAD_NOSYNC   _ENABLE
 #endif
+/** Program downloaded blocks from the main loop and report dfuDNBUSY while programming */
+#ifndef DFU_DNLOAD_ASYNC
+#define DFU_DNLOAD_ASYNC    _DISABLE
+#endif
+/** Skip erase and programming of the flash pages that already hold the downloaded data */
+#ifndef DFU_SKIP_UNCHANGED
+#define DFU_SKIP_UNCHANGED  _DISABLE
+#endif
+/** Don't program the erased (0xFF) data after the page erase */
+#ifndef DFU_SKIP_ERASED
+#define DFU_SKIP_ERASED     _DISABLE
+#endif
+/** Accept delta patches (fwcrypt -D) and compressed images (fwcrypt -z) */
+#ifndef DFU_PATCH
+#define DFU_PATCH           _DISABLE
+#endif
+/** Flash digest vendor request. Requires DFU_VERIFY_CHECKSUM */
+#ifndef DFU_DIGEST
+#define DFU_DIGEST          _DISABLE
+#endif
+/** Vendor interface with bulk endpoints for the download stream. See bulk.h */
+#ifndef DFU_BULK
+#define DFU_BULK            _DISABLE
+#endif
+/** Accept DfuSe Set Address and Erase commands (dfu-util -s) */
+#ifndef DFU_DFUSE
+#define DFU_DFUSE           _DISABLE
+#endif
+/** A/B updates. Download to the inactive flash bank and swap the banks. Requires DFU_VERIFY_CHECKSUM */
+#ifndef DFU_DUAL_BANK
+#define DFU_DUAL_BANK       _DISABLE
+#endif
+/** Resumable downloads. Progress journal in EEPROM or in the last flash page. Requires DFU_VERIFY_CHECKSUM */
+#ifndef DFU_RESUME
+#define DFU_RESUME          _DISABLE
+#endif
+/** Log control requests to the DFU interface to the RAM ring. Read by the vendor request */
+#ifndef DFU_TRACE
+#define DFU_TRACE           _DISABLE
+#endif
+/** Number of the DFU_TRACE entries, 12 bytes each */
+#ifndef DFU_TRACE_DEPTH
+#define DFU_TRACE_DEPTH     32
+#endif
 /** Add extra DFU interface for EEPROM */
 #ifndef DFU_INTF_EEPROM
 #define DFU_INTF_EEPROM     _AUTO
@@ -83,6 +133,10 @@
 #ifndef DFU_VERIFY_CHECKSUM
 #define DFU_VERIFY_CHECKSUM _DISABLE
 #endif
+/** Write boot record after the verified download. Startup skips full checksum while record is valid */
+#ifndef DFU_BOOT_RECORD
+#define DFU_BOOT_RECORD     _DISABLE
+#endif
 /** Memory Readout Protection level **/
 #ifndef DFU_SEAL_LEVEL
 #define DFU_SEAL_LEVEL      0
@@ -219,4 +273,11 @@
                             0xCC, 0xBB, 0xAA, 0x99, 0x44, 0x33, 0x22, 0x11
 #endif
 
+/* authentication tag size appended to the every DFU block */
+#if (DFU_CIPHER_MODE == DFU_CIPHER_AEAD)
+#define DFU_TAGSZ           16
+#else
+#define DFU_TAGSZ           0
+#endif
+
 #endif // _DFU_BOOTLOADER_H_
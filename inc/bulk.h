@@ -0,0 +1,108 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BULK_H_
+#define _BULK_H_
+#if defined(__cplusplus)
+    extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Bulk transport. The host writes the blocks of the DFU_DNLOAD stream to the
+ * bulk OUT endpoint, each one prefixed with @ref bulk_header. Packet
+ * boundaries don't matter. The device answers every block with
+ * @ref bulk_ack on the bulk IN endpoint after the block is taken by the
+ * DFU_DNLOAD processing. The host may send up to BULK_WINDOW blocks ahead of
+ * the acks. Zero-length block completes the download like the zero-length
+ * DFU_DNLOAD. After an error all blocks are answered with the error status
+ * until DFU_CLRSTATUS or DFU_ABORT on the control pipe.
+ */
+#define BULK_EP_OUT         0x01    /**<@brief bulk OUT endpoint address */
+#define BULK_EP_IN          0x81    /**<@brief bulk IN endpoint address */
+#define BULK_EP_SIZE        64      /**<@brief bulk endpoints size */
+#define BULK_WINDOW         2       /**<@brief blocks the host may send ahead of the acks */
+#define BULK_FIRST_BLOCK    2       /**<@brief first data block number, as DfuSe uses */
+
+/** @brief Block header. All fields are little-endian. */
+struct bulk_header {
+    uint16_t    wLength;            /**<@brief block length, 0 to complete the download */
+    uint16_t    wBlockNum;          /**<@brief DFU_DNLOAD wValue */
+} __attribute__((packed));
+
+/** @brief Block acknowledge */
+struct bulk_ack {
+    uint16_t    wBlockNum;          /**<@brief acknowledged block */
+    uint8_t     bStatus;            /**<@brief DFU status after the block */
+    uint8_t     bState;             /**<@brief DFU state after the block */
+} __attribute__((packed));
+
+/** @brief Device side block collector */
+struct bulk_rx {
+    uint8_t             *buf;
+    size_t              bufsz;
+    size_t              pos;        /**<@brief received header and data bytes */
+    struct bulk_header  hdr;
+};
+
+/** @brief Host side transport */
+struct bulk_link {
+    void    *ctx;
+    /** @brief Writes to the bulk OUT endpoint. Returns 0 on success */
+    int     (*send)(void *ctx, const void *data, size_t len);
+    /** @brief Reads one ack from the bulk IN endpoint. Returns 0 on success */
+    int     (*recv)(void *ctx, struct bulk_ack *ack);
+};
+
+/**
+ * @brief Starts collecting the next block.
+ * @param rx collector
+ * @param buf block buffer
+ * @param bufsz block buffer size
+ */
+void bulk_rx_init(struct bulk_rx *rx, void *buf, size_t bufsz);
+
+/**
+ * @brief Collects the received data.
+ * @param rx collector
+ * @param data received packet data
+ * @param len data length
+ * @return size_t consumed bytes. Data after the end of the block is left for the next one.
+ */
+size_t bulk_rx_feed(struct bulk_rx *rx, const void *data, size_t len);
+
+/**
+ * @brief Checks the collected block.
+ * @return true if the whole block is received
+ * @note Data that doesn't fit the buffer is dropped, check hdr.wLength against bufsz.
+ */
+bool bulk_rx_done(const struct bulk_rx *rx);
+
+/**
+ * @brief Sends the DFU_DNLOAD stream over the bulk pipe. Host side.
+ * @param link transport
+ * @param data stream, as it is sent by DFU_DNLOAD
+ * @param len stream length
+ * @param blksize DFU transfer size of the device (wTransferSize)
+ * @return int DFU status of the device or -1 on the transport error
+ */
+int bulk_download(const struct bulk_link *link, const void *data, size_t len, size_t blksize);
+
+#if defined(__cplusplus)
+    }
+#endif
+#endif // _BULK_H_
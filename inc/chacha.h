@@ -35,6 +35,33 @@ void chacha_init(const void* key, const void* nonce);
  */
 void chacha_crypt(void *out, const void *in);
 
+/** @brief Set keystream position
+ *  @param offset keystream offset in bytes from the start
+ */
+void chacha_seek(uint32_t offset);
+
+/** @brief Generate Poly1305 one-time key
+ *  @param out 32-byte key output
+ *  @note Key is the first half of the keystream block with counter 0 (RFC8439 2.6).
+ *        Keystream position is not changed.
+ */
+void chacha_poly_key(void *out);
+
+/** @brief Generate next 64-byte keystream block
+ *  @param out 32-bit aligned keystream output
+ *  @note Keystream position must be on the 64-byte block boundary
+ */
+void chacha_keystream(void *out);
+
+/** @brief Encrypt/Decrypt data
+ *  @param out cipher output
+ *  @param in  cipher input
+ *  @param sz  data size in bytes
+ *  @note Continues from the current keystream position. Whole 64-byte blocks
+ *        processed by the 32-bit words if both buffers are 32-bit aligned.
+ */
+void chacha_xor(void *out, const void *in, size_t sz);
+
 #if defined(__cplusplus)
     }
 #endif
@@ -27,22 +27,73 @@ extern const char *checksum_name;
 extern const size_t checksum_length;
 
 /**
- * @brief Calculate and append checksum to data.
- * @param data data buffer
- * @param len  data length
+ * @brief Write image header, calculate and append checksum to data.
+ * @param data image buffer, must be 32-bit aligned
+ * @param len  image length
  * @param bsize data buffer size
  * @return size_t length of the data with appended checksum or 0 if no enought space in buffer
+ *         or the reserved vector table entries 0x1C..0x2B are not zero.
+ * @note Image length and algorithm are stored at the reserved vector table
+ *       entries 0x1C and 0x28. Entries 0x20..0x27 are left erased for the
+ *       boot record. Checksum is appended right after the image.
  */
 size_t append_checksum(void *data, size_t len, size_t bsize);
 
 /**
- * @brief Find and derify checksum.
- * @param data data buffer
+ * @brief Get image length from the image header.
+ * @param data image buffer, must be 32-bit aligned
+ * @param bsize length of the data buffer
+ * @return size_t image length w/o checksum or 0 if no valid header found
+ * @note Checksum itself is not verified.
+ */
+size_t checksum_image_length(const void *data, size_t bsize);
+
+/**
+ * @brief Verify checksum using the image header.
+ * @param data image buffer, must be 32-bit aligned
  * @param bsize length of the data buffer
- * @return size_t length of the data w/o checksum or 0 if no data with correct checksum found
+ * @return size_t length of the data w/o checksum or 0 if no valid header or checksum found
+ * @note Checks exactly the image bytes in one pass.
  */
 size_t validate_checksum(const void *data, size_t bsize);
 
+/**
+ * @brief Calculate the image checksum the way it is appended to the image.
+ * @param digest output buffer of checksum_length bytes
+ * @param data image buffer, must be 32-bit aligned
+ * @param bsize length of the data buffer
+ * @return size_t image length w/o checksum or 0 if no valid header found
+ * @note Stored checksum is not compared.
+ */
+size_t checksum_image(void *digest, const void *data, size_t bsize);
+
+/**
+ * @brief Calculate checksum of the raw data.
+ * @param digest output buffer of checksum_length bytes
+ * @param data data buffer
+ * @param len data length
+ */
+void checksum_region(void *digest, const void *data, size_t len);
+
+/**
+ * @brief Start streaming verification of the image.
+ */
+void checksum_init(void);
+
+/**
+ * @brief Feed next part of the image. Data may be split at any position.
+ * @param data image data
+ * @param sz data length
+ * @note Data after the stored checksum is ignored.
+ */
+void checksum_update(const void *data, size_t sz);
+
+/**
+ * @brief Complete streaming verification.
+ * @return size_t length of the image w/o checksum or 0 if image is incomplete or checksum doesn't match
+ */
+size_t checksum_final(void);
+
 #if defined(__cplusplus)
     }
 #endif
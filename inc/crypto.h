@@ -20,14 +20,31 @@
 #endif
 /**
  * @brief Initialize cipher
+ * @note Expands the key. Call it once, then use @ref aes_reset to restart.
  */
 void aes_init(void);
 
+/**
+ * @brief Restart cipher from the initial vector
+ * @note Keeps the expanded key. Cipher must be initialized by @ref aes_init.
+ */
+void aes_reset(void);
+
+/**
+ * @brief Set cipher position for random access
+ * @param offset byte offset of the plain data. Must be on the cipher block boundary,
+ *        on the DFU block boundary in AEAD mode.
+ * @return 0 if success, -1 if cipher mode doesn't allow random access
+ * @note Supported for CTR, ECB, AEAD and CHACHA (C version) ciphers.
+ */
+int aes_seek(size_t offset);
+
 /**
  * @brief Encrypt data
  * @param out output buffer
  * @param in input buffer
  * @param sz data amount in bytes. must fit block size.
+ * @note buffers must be 32-bit aligned. out and in may be the same buffer.
  */
 void aes_encrypt(void *out, const void *in, size_t sz);
 
@@ -36,9 +53,43 @@ void aes_encrypt(void *out, const void *in, size_t sz);
  * @param out output buffer
  * @param in input buffer
  * @param sz data amount in bytes. must fit block size
+ * @note buffers must be 32-bit aligned. out and in may be the same buffer.
  */
 void aes_decrypt(void *out, const void *in, size_t sz);
 
+/**
+ * @brief Make the nonce block that starts the sealed image
+ * @param out output buffer of DFU_BLOCKSZ + DFU_TAGSZ bytes
+ * @param id 8-byte random image ID, must not be zero
+ * @return output size, DFU_BLOCKSZ + DFU_TAGSZ or 0 if cipher mode is not authenticated
+ * @note The following blocks are sealed with this image ID.
+ */
+size_t aes_seal_nonce(void *out, const void *id);
+
+/**
+ * @brief Encrypt and authenticate DFU block
+ * @param out output buffer. Must have room for DFU_TAGSZ bytes after data.
+ * @param in input buffer
+ * @param sz data amount in bytes. must fit block size.
+ * @return output size, data size + DFU_TAGSZ
+ * @note same as @ref aes_encrypt if cipher mode is not authenticated.
+ * @note Without @ref aes_seal_nonce the image ID is zero, such blocks can't be opened.
+ */
+size_t aes_seal(void *out, const void *in, size_t sz);
+
+/**
+ * @brief Authenticate and decrypt DFU block
+ * @param out output buffer
+ * @param in input buffer with the tag at the end
+ * @param sz input size including DFU_TAGSZ bytes of tag
+ * @return plain data size or -1 if authentication fails. Output is not
+ *         touched if authentication fails.
+ * @note same as @ref aes_decrypt if cipher mode is not authenticated.
+ * @note The first block after @ref aes_init, @ref aes_reset or @ref aes_seek
+ *       must be the nonce block made by @ref aes_seal_nonce. It returns 0.
+ */
+int aes_open(void *out, const void *in, size_t sz);
+
 /**
  * @brief Cipher name and mode
  */
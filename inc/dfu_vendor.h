@@ -0,0 +1,96 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DFU_VENDOR_H_
+#define _DFU_VENDOR_H_
+#if defined(__cplusplus)
+    extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Vendor specific requests to the DFU interface.
+ * bmRequestType is 0xC1 (device to host, vendor, interface) or 0x41 for
+ * DFU_VENDOR_RESUME, wIndex is the interface number. All fields are little-endian.
+ */
+
+/* Flash region for DFU_VENDOR_GETDIGEST is set in these units */
+#define DFU_DIGEST_UNIT         0x400
+
+/** @brief Returns @ref dfu_vendor_stats for the last download */
+#define DFU_VENDOR_GETSTATS     0x01
+
+/** @brief Download statistics */
+struct dfu_vendor_stats {
+    uint32_t    dwPagesSkipped;     /**<@brief Unchanged pages, not erased and programmed */
+    uint32_t    dwPagesProgrammed;  /**<@brief Erased and programmed pages */
+} __attribute__((packed));
+
+/** @brief Returns @ref dfu_vendor_digest computed on the device.
+ * wValue is 0 for the image at the application start or the number of
+ * DFU_DIGEST_UNIT bytes to hash from the DFU address pointer.
+ * With DFU_DNLOAD_ASYNC the request stalls while downloaded blocks are still
+ * pending. Poll GETSTATUS until dfuDNLOAD-IDLE and repeat it.
+ */
+#define DFU_VENDOR_GETDIGEST    0x02
+
+/** @brief Flash digest */
+struct dfu_vendor_digest {
+    uint32_t    dwAddress;          /**<@brief Region start */
+    uint32_t    dwLength;           /**<@brief Hashed length. 0 if no image header found */
+    uint8_t     bDigest[8];         /**<@brief Checksum in the fwcrypt byte order, zero padded */
+} __attribute__((packed));
+
+/** @brief Returns @ref dfu_vendor_journal of the interrupted download */
+#define DFU_VENDOR_GETJOURNAL   0x03
+
+/** @brief Sets @ref dfu_vendor_journal in the data stage. Host to device.
+ * dwOffset 0 starts the journaled download of the image dwImageId. Non-zero
+ * dwOffset must match the stored journal, the download continues from it with
+ * the next DFU_DNLOAD block. In DFU_CIPHER_AEAD mode the nonce block of the
+ * image is sent again before it. The interface must be in dfuIDLE state.
+ */
+#define DFU_VENDOR_RESUME       0x04
+
+/** @brief Download progress journal */
+struct dfu_vendor_journal {
+    uint32_t    dwImageId;          /**<@brief Host defined image id. 0 if there is no journal */
+    uint32_t    dwOffset;           /**<@brief Programmed and verified data, on the DFU block boundary */
+} __attribute__((packed));
+
+/** @brief Returns the request trace: uint32_t count of the recorded requests
+ * followed by the last DFU_TRACE_DEPTH @ref dfu_vendor_trace entries, oldest
+ * first. The request itself is not recorded. wValue 1 clears the trace.
+ */
+#define DFU_VENDOR_GETTRACE     0x05
+
+/* bStatus flag of the stalled request */
+#define DFU_TRACE_STALL         0x80
+
+/** @brief Control request to the DFU interface */
+struct dfu_vendor_trace {
+    uint8_t     bmRequestType;
+    uint8_t     bRequest;
+    uint16_t    wValue;
+    uint16_t    wLength;
+    uint8_t     bState;             /**<@brief DFU state after the request */
+    uint8_t     bStatus;            /**<@brief DFU status after the request, DFU_TRACE_STALL if stalled */
+    uint8_t     bData[4];           /**<@brief First bytes of the host to device data stage */
+} __attribute__((packed));
+
+#if defined(__cplusplus)
+    }
+#endif
+#endif // _DFU_VENDOR_H_
@@ -21,6 +21,14 @@
 __attribute__((long_call)) uint8_t program_eeprom(void *romaddr, const void *buffer, size_t blksize);
 __attribute__((long_call)) uint8_t program_flash(void *romaddr, const void *buffer, size_t blksize);
 __attribute__((long_call)) uint8_t seal_flash(void);
+__attribute__((long_call)) uint8_t swap_banks(void);
+/* STM32F4 sector lookup, FLASH_CR SNB | SER of the sector start or 0 */
+__attribute__((long_call)) uint8_t flash_sector(void *romaddr);
+/* STM32F4 sector erase in the background with DFU_DNLOAD_ASYNC */
+#define FLASH_BUSY  0xFF
+__attribute__((long_call)) uint8_t program_erased(void *romaddr, const void *buffer, size_t blksize);
+__attribute__((long_call)) uint8_t erase_sector(void *romaddr);
+__attribute__((long_call)) uint8_t flash_status(void);
 #if defined(__cplusplus)
     }
 #endif
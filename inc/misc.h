@@ -12,5 +12,10 @@
 #define BE32TOCPU(x)    (x)
 #endif
 
+/* Key schedules precomputed by the keygen. See DFU_CIPHER_ROMKEYS */
+#if defined(CIPHER_ROMKEYS)
+#include "romkeys.h"
+#endif
+
 
 #endif /* _MISC_H_ */
@@ -0,0 +1,109 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _PATCH_H_
+#define _PATCH_H_
+#if defined(__cplusplus)
+    extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Patch stream is a header followed by the operations. Each operation is an
+ * opcode byte followed by its LEB128 coded arguments. The new image is built
+ * in place over the old one. It is assembled in the RAM window and written
+ * when the window is full, so COPY may only read the old data from the current
+ * window or above it. A compressed image is a patch without COPY operations.
+ */
+#define PATCH_MAGIC         0x54504253UL    /**<@brief "SBPT" */
+#define PATCH_VERSION       1
+
+#define PATCH_OP_LITERAL    0x01    /**<@brief len, followed by len bytes */
+#define PATCH_OP_COPY       0x02    /**<@brief len, offset in the old image */
+#define PATCH_OP_MATCH      0x03    /**<@brief len, distance back in the new image */
+#define PATCH_OP_FILL       0x04    /**<@brief len, byte value */
+
+/* Return codes are the DFU status codes */
+#define PATCH_OK            0x00
+#define PATCH_ERR_FILE      0x02
+#define PATCH_ERR_ADDRESS   0x08
+#define PATCH_ERR_NOTDONE   0x09
+
+/** @brief Patch stream header. All fields are little-endian. */
+struct patch_header {
+    uint32_t    magic;          /**<@brief PATCH_MAGIC */
+    uint16_t    version;        /**<@brief PATCH_VERSION */
+    uint16_t    window;         /**<@brief window size the patch was made for */
+    uint32_t    size;           /**<@brief stream size including header. Trailing data is ignored */
+    uint32_t    length;         /**<@brief length of the new image */
+    uint32_t    base_length;    /**<@brief checked length of the old image or 0 for any */
+    uint32_t    base_digest;    /**<@brief first word of the old image digest */
+} __attribute__((packed));
+
+/**
+ * @brief Writes an assembled window of the new image.
+ * @param offset offset from the image start, window aligned
+ * @param data window data
+ * @param len data length, window size except for the last one
+ * @return PATCH_OK or DFU status code
+ */
+typedef uint8_t (*patch_write_fn)(size_t offset, const void *data, size_t len);
+
+/**
+ * @brief Starts applying a patch.
+ * @param base old image
+ * @param dest destination of the new image, usually the same as base
+ * @param limit max length of the new image
+ * @param window window buffer, must be 32-bit aligned
+ * @param wsize window size. Patches made for this size or its divisors are accepted
+ * @param base_length checked length of the old image or 0 if unknown
+ * @param base_digest first word of the old image digest
+ * @param write window write callback
+ */
+void patch_init(const void *base, const void *dest, size_t limit, void *window, size_t wsize,
+                size_t base_length, uint32_t base_digest, patch_write_fn write);
+
+/**
+ * @brief Feeds next part of the patch stream. Data may be split at any position.
+ * @return PATCH_OK or error code
+ */
+uint8_t patch_update(const void *data, size_t len);
+
+/**
+ * @brief Writes the last window and checks that the whole patch was applied.
+ * @return PATCH_OK or error code
+ */
+uint8_t patch_final(void);
+
+/**
+ * @brief Makes a patch stream or a compressed image if there is no old image. Host side.
+ * @param out output buffer
+ * @param outsz output buffer size
+ * @param img new image
+ * @param len new image length
+ * @param base old image or NULL
+ * @param baselen old image length or 0
+ * @param wsize target window size, power of 2
+ * @return size_t patch length or 0 if output buffer is too small
+ * @note Header base_length and base_digest are left zero.
+ */
+size_t patch_encode(void *out, size_t outsz, const void *img, size_t len,
+                    const void *base, size_t baselen, size_t wsize);
+
+#if defined(__cplusplus)
+    }
+#endif
+#endif // _PATCH_H_
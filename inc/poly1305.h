@@ -0,0 +1,45 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Poly1305 message authentication code implementation based on RFC8439
+ * "ChaCha20 and Poly1305 for IETF Protocols"
+ * https://tools.ietf.org/html/rfc8439
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _POLY1305_H_
+#define _POLY1305_H_
+#if defined(__cplusplus)
+    extern "C" {
+#endif
+
+/** @brief Initialize Poly1305 authenticator
+ *  @param key pointer to 256-bit one-time key
+ */
+void poly1305_init(const void *key);
+
+/** @brief Process message data
+ *  @param data pointer to data
+ *  @param sz data size in bytes
+ */
+void poly1305_update(const void *data, size_t sz);
+
+/** @brief Complete authentication
+ *  @param tag pointer to 128-bit tag output
+ */
+void poly1305_finish(void *tag);
+
+#if defined(__cplusplus)
+    }
+#endif
+#endif //_POLY1305_H_
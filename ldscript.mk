@@ -17,6 +17,7 @@ ROMLEN   ?= 256K
 RAMSTART ?= 0x20000000
 RAMLEN   ?= 32K
 APPALIGN ?= 0x0800
+STACKSZ  ?= 0x200
 OUTFILE  ?= script.ld
 
 define LDSCRIPT
@@ -62,8 +63,10 @@ __bss_start__ = .;
 . = ALIGN(4);
 __bss_end__ = .;
 } > RAM
+PROVIDE(__romstart = ORIGIN(ROM));
 PROVIDE(__romend = ORIGIN(ROM) + LENGTH(ROM));
 PROVIDE(__stack = ORIGIN(RAM) + LENGTH(RAM) - 4);
+ASSERT(__bss_end__ + $(STACKSZ) <= ORIGIN(RAM) + LENGTH(RAM), "Not enough RAM for the stack. Reduce DFU_BLOCKSZ")
 }
 endef
 
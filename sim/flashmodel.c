@@ -0,0 +1,292 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Flash model for the host simulator. Follows program_flash() and
+ * program_eeprom() of the mcu startup files: the programming unit and its
+ * alignment, the page erase when a unit starts the page and the
+ * verification. Timings are the typical datasheet values.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "config.h"
+#include "stm32.h"
+#include "usb_dfu.h"
+#include "flash.h"
+#include "sim.h"
+
+/* SIM_UNIT is the programming unit, SIM_PAD rounds the block up to it
+ * (the last unit is taken from the data after the block), otherwise the
+ * partial unit is not written. SIM_PAGE is the erase page or 0 for the
+ * sectors, SIM_OVERWRITE allows clearing bits of the programmed unit.
+ */
+#if defined(STM32L0)
+    #define SIM_FAMILY      "STM32L0"
+    #define SIM_UNIT        0x40
+    #define SIM_ALIGN       0x40
+    #define SIM_PAD         1
+    #define SIM_PAGE        0x80
+    #define SIM_ERASED      0x00
+    #define SIM_ERASE_NS    3200000
+    #define SIM_UNIT_NS     3200000
+    #define SIM_EEWORD_NS   3200000
+#elif defined(STM32L1)
+    #define SIM_FAMILY      "STM32L1"
+    #define SIM_UNIT        0x80
+    #define SIM_ALIGN       0x80
+    #define SIM_PAD         1
+    #define SIM_PAGE        0x100
+    #define SIM_ERASED      0x00
+    #define SIM_ERASE_NS    3280000
+    #define SIM_UNIT_NS     3280000
+    #define SIM_EEWORD_NS   3280000
+#elif defined(STM32F0) || defined(STM32F1) || defined(STM32F3)
+    #define SIM_FAMILY      "STM32F0/F1/F3"
+    #define SIM_UNIT        0x02
+    #define SIM_ALIGN       0x02
+    #define SIM_PAD         0
+    #if defined(STM32F030x4) || defined(STM32F030x6) || defined(STM32F030x8) || \
+        defined(STM32F070x6) || (defined(STM32F1) && !defined(STM32F103xE) && \
+        !defined(STM32F105xC) && !defined(STM32F107xC))
+        #define SIM_PAGE    0x400
+    #else
+        #define SIM_PAGE    0x800
+    #endif
+    #define SIM_ERASED      0xFF
+    #define SIM_ERASE_NS    20000000
+    #define SIM_UNIT_NS     52500
+#elif defined(STM32L4) || defined(STM32G4)
+    /* G4 Cat3 parts have 2K pages with DBANK set (factory default) */
+    #define SIM_FAMILY      "STM32L4/G4"
+    #define SIM_UNIT        0x08
+    #define SIM_ALIGN       0x08
+    #define SIM_PAD         1
+    #define SIM_PAGE        0x800
+    #define SIM_ERASED      0xFF
+    #define SIM_ERASE_NS    22000000
+    #define SIM_UNIT_NS     81700
+#elif defined(STM32F4)
+    /* 16K, 64K and 128K sectors in every MiB. x32 parallelism */
+    #define SIM_FAMILY      "STM32F4"
+    #define SIM_UNIT        0x04
+    #define SIM_ALIGN       0x08
+    #define SIM_PAD         1
+    #define SIM_PAGE        0
+    #define SIM_OVERWRITE
+    #define SIM_ERASED      0xFF
+    #define SIM_UNIT_NS     16000
+#else
+    #error Unsupported family. Check FWDEFS !!
+#endif
+
+/* sectors are 1MiB aligned as in the STM32F4 memory map */
+uint8_t sim_rom[SIM_ROMLEN] __attribute__((aligned(0x100000)));
+#if defined(DATA_EEPROM_BASE)
+uint8_t sim_eeprom[SIM_EELEN];
+#endif
+uint64_t sim_clock;
+uint32_t sim_swaps;
+
+void sim_flash_init(void) {
+    for (size_t i = 0; i < SIM_ROMLEN; i++) {
+        sim_rom[i] = SIM_ERASED;
+    }
+}
+
+void sim_flash_busy(uint64_t ns) {
+    sim_clock += ns;
+    sim_stats[sim_phase].flash_ns += ns;
+}
+
+const char *sim_flash_info(void) {
+    static char info[80];
+#if (SIM_PAGE != 0)
+    snprintf(info, sizeof(info), "%s, %d KiB flash, %d byte pages, %d byte unit",
+             SIM_FAMILY, SIM_ROMLEN >> 10, SIM_PAGE, SIM_UNIT);
+#else
+    snprintf(info, sizeof(info), "%s, %d KiB flash, 16/64/128 KiB sectors, %d byte unit",
+             SIM_FAMILY, SIM_ROMLEN >> 10, SIM_UNIT);
+#endif
+    return info;
+}
+
+/** Returns erase time if the offset is the start of the erase unit, 0 otherwise */
+static uint64_t sim_erase_ns(size_t offs) {
+#if (SIM_PAGE != 0)
+    return (offs % SIM_PAGE) ? 0 : SIM_ERASE_NS;
+#else
+    offs &= 0xFFFFF;
+    if (offs < 0x10000) return (offs & 0x3FFF) ? 0 : 500000000;
+    if (offs < 0x20000) return (offs & 0xFFFF) ? 0 : 1100000000;
+    return (offs & 0x1FFFF) ? 0 : 2000000000;
+#endif
+}
+
+static size_t sim_erase_size(size_t offs) {
+#if (SIM_PAGE != 0)
+    (void)offs;
+    return SIM_PAGE;
+#else
+    offs &= 0xFFFFF;
+    return (offs < 0x10000) ? 0x4000 : (offs < 0x20000) ? 0x10000 : 0x20000;
+#endif
+}
+
+#if (SIM_PAGE == 0)
+/* FLASH_CR SNB | SER of the sector start as the single bank table in mcu/stm32f4xx.S */
+uint8_t flash_sector(void *romaddr) {
+    size_t offs = (uint8_t*)romaddr - sim_rom;
+    if ((offs >= SIM_ROMLEN) || (sim_erase_ns(offs) == 0)) {
+        return 0;
+    }
+    size_t snb = (offs >> 20) << 4;
+    offs &= 0xFFFFF;
+    snb |= (offs < 0x10000) ? offs >> 14 : (offs < 0x20000) ? 4 : 4 + (offs >> 17);
+    return (uint8_t)((snb << 3) | 0x02);
+}
+#endif
+
+#if (SIM_PAGE == 0)
+/* sector erase started by erase_sector() ends at this time */
+static uint64_t sim_erase_end;
+static uint64_t sim_erase_poll;
+#endif
+
+/* flash operations wait for the background erase */
+static void sim_flash_wait(void) {
+#if (SIM_PAGE == 0)
+    if (sim_clock < sim_erase_end) {
+        sim_flash_busy(sim_erase_end - sim_clock);
+    }
+#endif
+}
+
+static uint8_t sim_program(void *romaddr, const void *buffer, size_t blksize, bool erase) {
+    const uint8_t *data = buffer;
+    size_t offs = (uint8_t*)romaddr - sim_rom;
+    if (offs & (SIM_ALIGN - 1)) {
+        return USB_DFU_STATUS_ERR_WRITE;
+    }
+#if (SIM_PAD)
+    blksize = (blksize + SIM_UNIT - 1) & ~(size_t)(SIM_UNIT - 1);
+#else
+    blksize &= ~(size_t)(SIM_UNIT - 1);
+#endif
+    if ((offs >= SIM_ROMLEN) || (blksize > SIM_ROMLEN - offs)) {
+        fprintf(stderr, "program_flash() out of the flash at %#zx\n", offs);
+        return USB_DFU_STATUS_ERR_ADDRESS;
+    }
+    sim_flash_wait();
+    for (size_t pos = 0; pos < blksize; pos += SIM_UNIT) {
+        uint8_t *rom = &sim_rom[offs + pos];
+        uint64_t ns = erase ? sim_erase_ns(offs + pos) : 0;
+        if (ns != 0) {
+            for (size_t i = 0; i < sim_erase_size(offs + pos); i++) {
+                rom[i] = SIM_ERASED;
+            }
+            sim_flash_busy(ns);
+            sim_stats[sim_phase].erases++;
+        }
+        bool erased = true;
+        for (size_t i = 0; i < SIM_UNIT; i++) {
+            erased = erased && (rom[i] == SIM_ERASED);
+        }
+#if defined(SIM_OVERWRITE)
+        for (size_t i = 0; i < SIM_UNIT; i++) {
+            rom[i] &= data[pos + i];
+        }
+#else
+        if (!erased) {
+            return USB_DFU_STATUS_ERR_PROG;
+        }
+        for (size_t i = 0; i < SIM_UNIT; i++) {
+            rom[i] = data[pos + i];
+        }
+#endif
+        sim_flash_busy(SIM_UNIT_NS);
+        sim_stats[sim_phase].programmed += SIM_UNIT;
+        for (size_t i = 0; i < SIM_UNIT; i++) {
+            if (rom[i] != data[pos + i]) {
+                return USB_DFU_STATUS_ERR_VERIFY;
+            }
+        }
+    }
+    return USB_DFU_STATUS_OK;
+}
+
+uint8_t program_flash(void *romaddr, const void *buffer, size_t blksize) {
+    return sim_program(romaddr, buffer, blksize, true);
+}
+
+#if (SIM_PAGE == 0)
+uint8_t program_erased(void *romaddr, const void *buffer, size_t blksize) {
+    return sim_program(romaddr, buffer, blksize, false);
+}
+
+/* The sector is erased right away, the time runs in the background */
+uint8_t erase_sector(void *romaddr) {
+    size_t offs = (uint8_t*)romaddr - sim_rom;
+    uint64_t ns = (offs < SIM_ROMLEN) ? sim_erase_ns(offs) : 0;
+    if (ns == 0) {
+        return 0;
+    }
+    sim_flash_wait();
+    for (size_t i = 0; i < sim_erase_size(offs); i++) {
+        sim_rom[offs + i] = SIM_ERASED;
+    }
+    sim_erase_end = sim_clock + ns;
+    sim_erase_poll = ~0ULL;
+    sim_stats[sim_phase].erases++;
+    return 1;
+}
+
+/* The main loop polls between the transfers. Polls with no time passed
+ * are the busy loop, the CPU waits for the rest of the erase.
+ */
+uint8_t flash_status(void) {
+    if (sim_clock < sim_erase_end) {
+        if (sim_clock != sim_erase_poll) {
+            sim_erase_poll = sim_clock;
+            return FLASH_BUSY;
+        }
+        sim_flash_busy(sim_erase_end - sim_clock);
+    }
+    return USB_DFU_STATUS_OK;
+}
+#endif
+
+#if defined(DATA_EEPROM_BASE)
+/* word writes, the block is rounded up */
+uint8_t program_eeprom(void *romaddr, const void *buffer, size_t blksize) {
+    uint8_t *ee = romaddr;
+    const uint8_t *data = buffer;
+    for (size_t pos = 0; pos < blksize; pos += 4) {
+        for (size_t i = 0; i < 4; i++) {
+            ee[pos + i] = data[pos + i];
+        }
+        sim_flash_busy(SIM_EEWORD_NS);
+        sim_stats[sim_phase].eeprom += 4;
+    }
+    return USB_DFU_STATUS_OK;
+}
+#endif
+
+/* option bytes reload resets the device, the simulation ends with System_Reset() */
+uint8_t swap_banks(void) {
+    sim_swaps++;
+    return USB_DFU_STATUS_OK;
+}
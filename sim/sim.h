@@ -0,0 +1,80 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _SIM_H_
+#define _SIM_H_
+#if defined(__cplusplus)
+    extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(SIM_ROMLEN)
+    #define SIM_ROMLEN  0x10000
+#endif
+
+/* Session phases. Modelled time and counters go to the current one */
+enum sim_phase {
+    SIM_SETUP,
+    SIM_ERASE,
+    SIM_DOWNLOAD,
+    SIM_MANIFEST,
+    SIM_UPLOAD,
+    SIM_PHASES,
+};
+
+/** @brief Phase statistics. Times are in ns */
+struct sim_stats {
+    uint64_t    usb_ns;         /**<@brief bus packets */
+    uint64_t    flash_ns;       /**<@brief erase and programming, the CPU is stalled */
+    uint64_t    host_ns;        /**<@brief host turnaround, the device is idle */
+    uint64_t    wait_ns;        /**<@brief host waits bwPollTimeout, the device is idle */
+    uint64_t    cpu_ns;         /**<@brief host CPU time spent in the bootloader code */
+    uint32_t    transfers;      /**<@brief control transfers */
+    uint32_t    packets;        /**<@brief bus transactions, including setup and status */
+    uint32_t    stalls;
+    uint32_t    blocks;         /**<@brief DNLOAD and UPLOAD requests with data */
+    uint32_t    bytes;          /**<@brief data of the blocks */
+    uint32_t    erases;
+    uint32_t    programmed;     /**<@brief flash bytes */
+    uint32_t    eeprom;         /**<@brief EEPROM bytes */
+};
+
+extern uint64_t         sim_clock;
+extern enum sim_phase   sim_phase;
+extern struct sim_stats sim_stats[SIM_PHASES];
+extern uint8_t          sim_rom[];
+extern uint32_t         sim_swaps;
+
+/** @brief Fills the flash model with the erased value */
+void sim_flash_init(void);
+
+/**
+ * @brief Advances the modelled time by the flash operation.
+ * @param ns duration
+ */
+void sim_flash_busy(uint64_t ns);
+
+/**
+ * @brief Describes the modelled flash.
+ * @return const char* family, size and geometry
+ */
+const char *sim_flash_info(void);
+
+#if defined(__cplusplus)
+    }
+#endif
+#endif // _SIM_H_
@@ -0,0 +1,772 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Host simulator of the bootloader. The unmodified bootloader runs against
+ * the usbd core mock below and the flash model. The host side is a dfu-util
+ * like download of the fwcrypt output or the replay of the recorded session,
+ * both driven from usbd_poll(). Time is
+ * modelled: full speed EP0 packets, host turnaround between the transfers,
+ * bwPollTimeout waits and the flash operations. CPU time is measured on the
+ * host for the bootloader code.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "getopt.h"
+#include "config.h"
+#include "usb.h"
+#include "usb_dfu.h"
+#include "crypto.h"
+#include "checksum.h"
+#include "dfu_vendor.h"
+#include "sim.h"
+
+/* full speed bit time, ns */
+#define SIM_BIT_NS      83
+/* token, handshake, sync, PID, CRC, EOP and inter-packet gaps, bytes */
+#define SIM_PKT_EXTRA   16
+#define SIM_SETUP_SZ    8
+#define SIM_BUFSZ       0x1100
+#define SIM_TRACESZ     0x10000
+#define DFUSE_ERASE     0x41
+
+enum sim_host {
+    HOST_SETINTF,
+    HOST_STATUS,
+    HOST_DNLOAD,
+    HOST_DNSTATUS,
+    HOST_MANIFEST,
+    HOST_MNSTATUS,
+    HOST_UPLOAD,
+    HOST_DETACH,
+    HOST_DONE,
+};
+
+static const char *sim_phase_name[SIM_PHASES] = {
+    "setup", "erase", "download", "manifest", "upload",
+};
+
+extern uint8_t __app_start;
+int bootloader_main(void);
+
+const struct usbd_driver usbd_sim = {
+    .name = "simulator",
+};
+
+enum sim_phase sim_phase;
+struct sim_stats sim_stats[SIM_PHASES];
+
+static struct {
+    const uint8_t   *image;
+    size_t          length;
+    size_t          offset;
+    uint16_t        block;
+    uint16_t        xfersize;
+    uint64_t        turnaround;
+    uint64_t        ready;      /* host issues the next transfer */
+    uint64_t        last;       /* modelled time at the last usbd_poll() return */
+    bool            wait;       /* host is waiting bwPollTimeout */
+    bool            upload;
+    bool            detach;
+    bool            nosync;
+    bool            verbose;
+    const char      *outfile;
+    const char      *logfile;
+    struct dfu_vendor_trace *trace;
+    size_t          tracelen;
+    size_t          traceidx;
+    bool            polling;    /* replay polls until the device is not busy */
+    usbd_device     *dev;
+    enum sim_host   host;
+    uint8_t         bStatus;
+    uint8_t         bState;
+    uint64_t        cpu_mark;
+    uint8_t         buf[SIM_BUFSZ];
+} sim;
+
+static uint64_t sim_cputime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* bootloader CPU time since the mark goes to the current phase */
+static void sim_cpu_account(void) {
+    uint64_t now = sim_cputime();
+    sim_stats[sim_phase].cpu_ns += now - sim.cpu_mark;
+    sim.cpu_mark = now;
+}
+
+static void sim_packet(size_t len) {
+    uint64_t ns = (len + SIM_PKT_EXTRA) * 8 * SIM_BIT_NS;
+    sim_clock += ns;
+    sim_stats[sim_phase].usb_ns += ns;
+    sim_stats[sim_phase].packets++;
+}
+
+static void sim_data_packets(usbd_device *dev, size_t len) {
+    size_t ep0 = dev->status.ep0size;
+    while (len >= ep0) {
+        sim_packet(ep0);
+        len -= ep0;
+    }
+    if (len != 0) {
+        sim_packet(len);
+    }
+}
+
+/* standard device requests handled by the usbd core */
+static usbd_respond sim_standard(usbd_device *dev, usbd_ctlreq *req) {
+    if ((req->bmRequestType & (USB_REQ_TYPE | USB_REQ_RECIPIENT)) != (USB_REQ_STANDARD | USB_REQ_DEVICE)) {
+        return usbd_fail;
+    }
+    switch (req->bRequest) {
+    case USB_STD_GET_DESCRIPTOR:
+        if (dev->descriptor_callback == NULL) {
+            return usbd_fail;
+        }
+        return dev->descriptor_callback(req, &dev->status.data_ptr, &dev->status.data_count);
+    case USB_STD_SET_ADDRESS:
+        return usbd_ack;
+    case USB_STD_SET_CONFIG:
+        if ((dev->config_callback == NULL) ||
+            (dev->config_callback(dev, req->wValue) != usbd_ack)) {
+            return usbd_fail;
+        }
+        dev->status.device_cfg = req->wValue;
+        return usbd_ack;
+    default:
+        return usbd_fail;
+    }
+}
+
+/**
+ * Runs the control transfer when the host is ready.
+ * Returns the data stage length or -1 if the request is stalled.
+ */
+static int sim_control(usbd_device *dev, uint8_t type, uint8_t request, uint16_t value,
+                       void *data, uint16_t length) {
+    usbd_ctlreq *req = dev->status.data_buf;
+    struct sim_stats *st = &sim_stats[sim_phase];
+    /* device is idle until the host comes */
+    if (sim_clock < sim.ready) {
+        if (sim.wait) {
+            st->wait_ns += sim.ready - sim_clock;
+        } else {
+            st->host_ns += sim.ready - sim_clock;
+        }
+        sim_clock = sim.ready;
+    }
+    uint64_t start = sim_clock;
+    int res = -1;
+    st->transfers++;
+    sim_packet(SIM_SETUP_SZ);
+    if (((type & USB_REQ_DEVTOHOST) == 0) && (length > dev->status.data_maxsize)) {
+        /* doesn't fit the buffer, the core stalls the data stage */
+        sim_packet(0);
+        st->stalls++;
+    } else {
+        req->bmRequestType = type;
+        req->bRequest = request;
+        req->wValue = value;
+        req->wIndex = 0;
+        req->wLength = length;
+        dev->status.data_ptr = req->data;
+        if (type & USB_REQ_DEVTOHOST) {
+            dev->status.data_count = dev->status.data_maxsize;
+        } else {
+            memcpy(req->data, data, length);
+            dev->status.data_count = length;
+            sim_data_packets(dev, length);
+        }
+        dev->complete_callback = NULL;
+        usbd_respond r = usbd_fail;
+        sim.cpu_mark = sim_cputime();
+        if (dev->control_callback != NULL) {
+            r = dev->control_callback(dev, req, &dev->complete_callback);
+        }
+        if (r == usbd_fail) {
+            r = sim_standard(dev, req);
+        }
+        sim_cpu_account();
+        if (r != usbd_ack) {
+            sim_packet(0);
+            st->stalls++;
+        } else if (type & USB_REQ_DEVTOHOST) {
+            res = (dev->status.data_count < length) ? dev->status.data_count : length;
+            memcpy(data, dev->status.data_ptr, res);
+            sim_data_packets(dev, res);
+            if ((res < length) && ((res % dev->status.ep0size) == 0)) {
+                /* ZLP */
+                sim_packet(0);
+            }
+            sim_packet(0);
+        } else {
+            res = length;
+            sim_packet(0);
+        }
+    }
+    if (sim.verbose) {
+        printf("%10.3f ms  %02X %02X %5d %4d  %s  %.3f ms\n", start / 1e6, type, request, value,
+               length, (res < 0) ? "STALL" : "ACK  ", (sim_clock - start) / 1e6);
+    }
+    sim.ready = sim_clock + sim.turnaround;
+    sim.wait = false;
+    if ((res >= 0) && (dev->complete_callback != NULL)) {
+        sim.cpu_mark = sim_cputime();
+        dev->complete_callback(dev, req);
+        sim_cpu_account();
+    }
+    return res;
+}
+
+static int sim_dfu_request(usbd_device *dev, uint8_t request, void *data, uint16_t length, bool in) {
+    uint8_t type = USB_REQ_CLASS | USB_REQ_INTERFACE | (in ? USB_REQ_DEVTOHOST : 0);
+    return sim_control(dev, type, request, sim.block, data, length);
+}
+
+/* Returns true if the device is done with the request */
+static bool sim_getstatus(usbd_device *dev) {
+    struct usb_dfu_status *stat = (void*)sim.buf;
+    const uint8_t type = USB_REQ_DEVTOHOST | USB_REQ_CLASS | USB_REQ_INTERFACE;
+    if (sim_control(dev, type, USB_DFU_GETSTATUS, 0, stat, sizeof(*stat)) != sizeof(*stat)) {
+        sim.bStatus = USB_DFU_STATUS_ERR_STALLEDPKT;
+        sim.bState = USB_DFU_STATE_DFU_ERROR;
+        return true;
+    }
+    sim.bStatus = stat->bStatus;
+    sim.bState = stat->bState;
+    switch (sim.bState) {
+    case USB_DFU_STATE_DFU_IDLE:
+    case USB_DFU_STATE_DFU_DNLOADIDLE:
+    case USB_DFU_STATE_DFU_ERROR:
+        return true;
+    default:
+        /* busy, the host sleeps bwPollTimeout */
+        sim.ready = sim_clock + (stat->bPollTimeout | (uint32_t)stat->wPollTimeout << 8) * 1000000ULL;
+        sim.wait = true;
+        return false;
+    }
+}
+
+static void sim_report(void) {
+    struct sim_stats total = {0};
+    printf("\ntarget   : %s\n", sim_flash_info());
+    printf("cipher   : %s, checksum %s\n", aes_name, checksum_name);
+    printf("transfer : %d byte blocks, %d byte EP0, %d us turnaround%s\n", sim.xfersize,
+           DFU_EP0_SIZE, (int)(sim.turnaround / 1000), sim.nosync ? ", no GETSTATUS" : "");
+    if (sim.trace != NULL) {
+        printf("replay   : %zu of %zu requests, %zu of %zu image bytes sent\n", sim.traceidx, sim.tracelen,
+               sim.offset, sim.length);
+    }
+    printf("result   : status %d, state %d%s\n\n", sim.bStatus, sim.bState,
+           (sim_swaps != 0) ? ", banks swapped" : "");
+    printf("phase      time ms   usb ms flash ms  host ms  wait ms xfers pkts blocks   bytes erases  written cpu us/blk\n");
+    for (int i = 0; i <= SIM_PHASES; i++) {
+        struct sim_stats *st = &total;
+        const char *name = "total";
+        if (i < SIM_PHASES) {
+            st = &sim_stats[i];
+            name = sim_phase_name[i];
+            total.usb_ns += st->usb_ns;
+            total.flash_ns += st->flash_ns;
+            total.host_ns += st->host_ns;
+            total.wait_ns += st->wait_ns;
+            total.cpu_ns += st->cpu_ns;
+            total.transfers += st->transfers;
+            total.packets += st->packets;
+            total.blocks += st->blocks;
+            total.bytes += st->bytes;
+            total.erases += st->erases;
+            total.programmed += st->programmed;
+            total.eeprom += st->eeprom;
+        }
+        uint64_t time = st->usb_ns + st->flash_ns + st->host_ns + st->wait_ns;
+        printf("%-9s%9.1f%9.1f%9.1f%9.1f%9.1f%6u%5u%7u%8u%7u%9u%11.1f\n", name, time / 1e6,
+               st->usb_ns / 1e6, st->flash_ns / 1e6, st->host_ns / 1e6, st->wait_ns / 1e6,
+               st->transfers, st->packets, st->blocks, st->bytes, st->erases,
+               st->programmed + st->eeprom, st->blocks ? st->cpu_ns / 1e3 / st->blocks : 0.0);
+    }
+    const struct sim_stats *dn = &sim_stats[SIM_DOWNLOAD];
+    uint64_t dntime = dn->usb_ns + dn->flash_ns + dn->host_ns + dn->wait_ns;
+    if (dntime != 0) {
+        printf("\ndownload : %.2f KiB/s\n", dn->bytes / 1024.0 / (dntime / 1e9));
+    }
+}
+
+static bool sim_is_dfu(const struct dfu_vendor_trace *e, uint8_t request) {
+    return ((e->bmRequestType & (USB_REQ_TYPE | USB_REQ_RECIPIENT)) == (USB_REQ_CLASS | USB_REQ_INTERFACE)) &&
+           (e->bRequest == request);
+}
+
+/* DfuSe Set Address and Erase are the 5 byte DFU_DNLOAD of the block 0 */
+static bool sim_is_dfuse(const struct dfu_vendor_trace *e) {
+    return sim_is_dfu(e, USB_DFU_DNLOAD) && (e->wValue == 0) && (e->wLength == 5);
+}
+
+/* Trace file has a line per request: bmRequestType bRequest wValue wLength
+ * bState bStatus data, hex fields of struct dfu_vendor_trace. Lines starting
+ * with # are comments.
+ */
+static void sim_savetrace(void) {
+    static uint8_t log[SIM_TRACESZ];
+    const uint8_t type = USB_REQ_DEVTOHOST | USB_REQ_VENDOR | USB_REQ_INTERFACE;
+    int len = sim_control(sim.dev, type, DFU_VENDOR_GETTRACE, 0, log, SIM_TRACESZ - 1);
+    if (len < 4) {
+        printf("No request trace. Check DFU_TRACE.\n");
+        exit(3);
+    }
+    FILE *fo = fopen(sim.logfile, "w");
+    if (fo == NULL) {
+        printf("Failed to write %s.\n", sim.logfile);
+        exit(3);
+    }
+    uint32_t count = log[0] | log[1] << 8 | log[2] << 16 | (uint32_t)log[3] << 24;
+    size_t n = (len - 4) / sizeof(struct dfu_vendor_trace);
+    fprintf(fo, "# %u requests, last %zu recorded\n", count, n);
+    fprintf(fo, "# type req value length state status data\n");
+    for (size_t i = 0; i < n; i++) {
+        struct dfu_vendor_trace *e = (void*)&log[4 + i * sizeof(*e)];
+        if (sim_is_dfuse(e)) {
+            /* flash offset as on the device */
+            uint32_t offs = (e->bData[1] | e->bData[2] << 8 | e->bData[3] << 16) - (size_t)sim_rom;
+            for (size_t j = 1; j < 4; j++) {
+                e->bData[j] = offs >> ((j - 1) * 8);
+            }
+        }
+        fprintf(fo, "%02X %02X %04X %04X %02X %02X %02X%02X%02X%02X\n", e->bmRequestType, e->bRequest,
+                e->wValue, e->wLength, e->bState, e->bStatus, e->bData[0], e->bData[1], e->bData[2], e->bData[3]);
+    }
+    fclose(fo);
+}
+
+static void sim_loadtrace(const char *name) {
+    char line[128];
+    size_t size = 0;
+    FILE *fi = fopen(name, "r");
+    if (fi == NULL) {
+        printf("Failed to open %s.\n", name);
+        exit(2);
+    }
+    while (fgets(line, sizeof(line), fi) != NULL) {
+        unsigned f[6] = {0};
+        char data[9] = "00000000";
+        int n = sscanf(line, "%x %x %x %x %x %x %8s", &f[0], &f[1], &f[2], &f[3], &f[4], &f[5], data);
+        if ((line[0] == '#') || (n <= 0)) {
+            continue;
+        }
+        if ((n < 4) || (f[3] > SIM_BUFSZ) || (strlen(data) != 8)) {
+            printf("Bad trace line: %s", line);
+            exit(3);
+        }
+        if (sim.tracelen == size) {
+            size = size ? size * 2 : 256;
+            sim.trace = realloc(sim.trace, size * sizeof(*sim.trace));
+            if (sim.trace == NULL) {
+                printf("Failed to read %s.\n", name);
+                exit(3);
+            }
+        }
+        struct dfu_vendor_trace *e = &sim.trace[sim.tracelen++];
+        e->bmRequestType = f[0];
+        e->bRequest = f[1];
+        e->wValue = f[2];
+        e->wLength = f[3];
+        e->bState = f[4];
+        e->bStatus = f[5];
+        for (size_t i = 0; i < sizeof(e->bData); i++) {
+            unsigned b;
+            sscanf(&data[i * 2], "%2x", &b);
+            e->bData[i] = b;
+        }
+    }
+    fclose(fi);
+    if (sim.tracelen == 0) {
+        printf("Empty trace %s.\n", name);
+        exit(3);
+    }
+}
+
+static void sim_exit(void) {
+    sim_report();
+    if (sim.outfile != NULL) {
+        size_t applen = sim_rom + SIM_ROMLEN - &__app_start;
+        FILE *fo = fopen(sim.outfile, "wb");
+        if ((fo == NULL) || (fwrite(&__app_start, 1, applen, fo) != applen)) {
+            printf("Failed to write %s.\n", sim.outfile);
+            exit(3);
+        }
+        fclose(fo);
+    }
+    if (sim.logfile != NULL) {
+        sim_savetrace();
+    }
+    exit((sim.bStatus == USB_DFU_STATUS_OK) ? 0 : 1);
+}
+
+/* device reset after DFU_DETACH ends the simulation */
+void System_Reset(void) {
+    sim_exit();
+}
+
+/* dfu-util like host. Runs one transfer */
+static void sim_host(usbd_device *dev) {
+    switch (sim.host) {
+    case HOST_SETINTF:
+        sim_control(dev, USB_REQ_STANDARD | USB_REQ_INTERFACE, USB_STD_SET_INTERFACE, 0, NULL, 0);
+        sim.host = HOST_STATUS;
+        break;
+    case HOST_STATUS:
+        if (sim_getstatus(dev)) {
+            if (sim.bState == USB_DFU_STATE_DFU_ERROR) {
+                sim.host = HOST_DONE;
+            } else {
+                sim.host = HOST_DNLOAD;
+                sim_phase = SIM_DOWNLOAD;
+            }
+        }
+        break;
+    case HOST_DNLOAD:
+        if (sim.offset < sim.length) {
+            size_t len = sim.length - sim.offset;
+            if (len > sim.xfersize) {
+                len = sim.xfersize;
+            }
+            memcpy(sim.buf, &sim.image[sim.offset], len);
+            if (sim_dfu_request(dev, USB_DFU_DNLOAD, sim.buf, len, false) < 0) {
+                sim.bStatus = USB_DFU_STATUS_ERR_STALLEDPKT;
+                sim.bState = USB_DFU_STATE_DFU_ERROR;
+                sim.host = HOST_DONE;
+                break;
+            }
+            sim_stats[sim_phase].blocks++;
+            sim_stats[sim_phase].bytes += len;
+            sim.offset += len;
+            sim.block++;
+            if (!sim.nosync) {
+                sim.host = HOST_DNSTATUS;
+            }
+        } else {
+            sim.host = HOST_MANIFEST;
+        }
+        break;
+    case HOST_DNSTATUS:
+        if (sim_getstatus(dev)) {
+            sim.host = (sim.bState == USB_DFU_STATE_DFU_ERROR) ? HOST_DONE : HOST_DNLOAD;
+        }
+        break;
+    case HOST_MANIFEST:
+        sim_phase = SIM_MANIFEST;
+        sim_dfu_request(dev, USB_DFU_DNLOAD, NULL, 0, false);
+        sim.host = HOST_MNSTATUS;
+        break;
+    case HOST_MNSTATUS:
+        if (sim_getstatus(dev)) {
+            if ((sim.bState == USB_DFU_STATE_DFU_ERROR) || !sim.upload) {
+                sim.host = HOST_DETACH;
+            } else {
+                sim.host = HOST_UPLOAD;
+                sim_phase = SIM_UPLOAD;
+                sim.block = 2;
+            }
+        }
+        break;
+    case HOST_UPLOAD:
+        {
+            int len = sim_dfu_request(dev, USB_DFU_UPLOAD, sim.buf, sim.xfersize, true);
+            if (len > 0) {
+                sim_stats[sim_phase].blocks++;
+                sim_stats[sim_phase].bytes += len;
+                sim.block++;
+            }
+            if (len < sim.xfersize) {
+                sim.host = HOST_DETACH;
+            }
+        }
+        break;
+    case HOST_DETACH:
+        if (sim.detach) {
+            sim_dfu_request(dev, USB_DFU_DETACH, NULL, 0, false);
+        }
+        sim.host = HOST_DONE;
+        break;
+    default:
+        sim_exit();
+    }
+}
+
+/* Replays the recorded session. Runs one transfer. DFU_GETSTATUS polling goes
+ * on while the simulated device is busy, so the polls follow the device, not
+ * the recording. Data blocks are taken from the image, DfuSe addresses are
+ * recorded as the offset in the flash.
+ */
+static void sim_replay(usbd_device *dev) {
+    if (sim.polling) {
+        sim.polling = !sim_getstatus(dev);
+        return;
+    }
+    if (sim.traceidx == sim.tracelen) {
+        sim_exit();
+    }
+    const struct dfu_vendor_trace *e = &sim.trace[sim.traceidx++];
+    if (sim_is_dfu(e, USB_DFU_GETSTATUS)) {
+        bool last = (sim.traceidx == sim.tracelen) || !sim_is_dfu(&sim.trace[sim.traceidx], USB_DFU_GETSTATUS);
+        sim.polling = !sim_getstatus(dev) && last;
+        return;
+    }
+    bool block = false;
+    memset(sim.buf, 0, e->wLength);
+    memcpy(sim.buf, e->bData, (e->wLength < sizeof(e->bData)) ? e->wLength : sizeof(e->bData));
+    if (sim_is_dfu(e, USB_DFU_DNLOAD)) {
+        if (e->wLength == 0) {
+            sim_phase = SIM_MANIFEST;
+        } else if (sim_is_dfuse(e)) {
+            uint32_t addr = (uint32_t)(size_t)sim_rom + (e->bData[1] | e->bData[2] << 8 | e->bData[3] << 16);
+            for (size_t i = 0; i < 4; i++) {
+                sim.buf[i + 1] = addr >> (i * 8);
+            }
+            if (e->bData[0] == DFUSE_ERASE) {
+                sim_phase = SIM_ERASE;
+            } else if (sim_phase < SIM_DOWNLOAD) {
+                sim_phase = SIM_DOWNLOAD;
+            }
+        } else {
+            size_t len = (sim.length - sim.offset < e->wLength) ? sim.length - sim.offset : e->wLength;
+            memcpy(sim.buf, &sim.image[sim.offset], len);
+            sim.offset += len;
+            sim_phase = SIM_DOWNLOAD;
+            block = true;
+        }
+    } else if (sim_is_dfu(e, USB_DFU_UPLOAD) && ((e->wValue != 0) || (sim_phase != SIM_SETUP))) {
+        /* DfuSe Get Commands before the download is the part of the setup */
+        sim_phase = SIM_UPLOAD;
+        block = true;
+    }
+    int len = sim_control(dev, e->bmRequestType, e->bRequest, e->wValue, sim.buf, e->wLength);
+    if (block && (len > 0)) {
+        sim_stats[sim_phase].blocks++;
+        sim_stats[sim_phase].bytes += len;
+    }
+}
+
+void usbd_init(usbd_device *dev, const struct usbd_driver *drv, const uint8_t ep0size, uint32_t *buffer, const uint16_t bsize) {
+    memset(dev, 0, sizeof(*dev));
+    sim.dev = dev;
+    dev->driver = drv;
+    dev->status.ep0size = ep0size;
+    dev->status.data_buf = buffer;
+    dev->status.data_ptr = buffer;
+    dev->status.data_maxsize = bsize - offsetof(usbd_ctlreq, data);
+}
+
+void usbd_reg_control(usbd_device *dev, usbd_ctl_callback callback) {
+    dev->control_callback = callback;
+}
+
+void usbd_reg_config(usbd_device *dev, usbd_cfg_callback callback) {
+    dev->config_callback = callback;
+}
+
+void usbd_reg_descr(usbd_device *dev, usbd_dsc_callback callback) {
+    dev->descriptor_callback = callback;
+}
+
+void usbd_reg_endpoint(usbd_device *dev, uint8_t ep, usbd_evt_callback callback) {
+    dev->endpoint[ep & 0x07] = callback;
+}
+
+void usbd_reg_event(usbd_device *dev, uint8_t evt, usbd_evt_callback callback) {
+    dev->events[evt] = callback;
+}
+
+void usbd_enable(usbd_device *dev, bool enable) {
+    (void)dev;
+    (void)enable;
+}
+
+/* Enumerates the device and reads wTransferSize */
+void usbd_connect(usbd_device *dev, bool connect) {
+    const uint8_t std = USB_REQ_STANDARD | USB_REQ_DEVICE;
+    if (!connect) {
+        return;
+    }
+    sim_control(dev, std | USB_REQ_DEVTOHOST, USB_STD_GET_DESCRIPTOR, USB_DTYPE_DEVICE << 8, sim.buf, 18);
+    sim_control(dev, std, USB_STD_SET_ADDRESS, 1, NULL, 0);
+    sim_control(dev, std | USB_REQ_DEVTOHOST, USB_STD_GET_DESCRIPTOR, USB_DTYPE_CONFIGURATION << 8, sim.buf, 9);
+    uint16_t total = sim.buf[2] | sim.buf[3] << 8;
+    int len = sim_control(dev, std | USB_REQ_DEVTOHOST, USB_STD_GET_DESCRIPTOR, USB_DTYPE_CONFIGURATION << 8, sim.buf, total);
+    for (int pos = 0; (pos + 1 < len) && (sim.buf[pos] != 0); pos += sim.buf[pos]) {
+        if (sim.buf[pos + 1] == USB_DTYPE_DFU_FUNCTIONAL) {
+            sim.xfersize = sim.buf[pos + 5] | sim.buf[pos + 6] << 8;
+        }
+    }
+    sim_control(dev, std, USB_STD_SET_CONFIG, 1, NULL, 0);
+    if ((sim.xfersize == 0) || (sim.xfersize > SIM_BUFSZ)) {
+        printf("No DFU functional descriptor found.\n");
+        exit(4);
+    }
+}
+
+bool usbd_ep_config(usbd_device *dev, uint8_t ep, uint8_t eptype, uint16_t epsize) {
+    (void)dev;
+    (void)ep;
+    (void)eptype;
+    (void)epsize;
+    return true;
+}
+
+void usbd_ep_deconfig(usbd_device *dev, uint8_t ep) {
+    (void)dev;
+    (void)ep;
+}
+
+int32_t usbd_ep_read(usbd_device *dev, uint8_t ep, void *buf, uint16_t blen) {
+    (void)dev;
+    (void)ep;
+    (void)buf;
+    (void)blen;
+    return -1;
+}
+
+int32_t usbd_ep_write(usbd_device *dev, uint8_t ep, const void *buf, uint16_t blen) {
+    (void)dev;
+    (void)ep;
+    (void)buf;
+    (void)blen;
+    return -1;
+}
+
+/* The main loop work between the polls is the background programming. The
+ * host transfer is run when the main loop has nothing more to do or the
+ * host is ready anyway.
+ */
+void usbd_poll(usbd_device *dev) {
+    sim_cpu_account();
+    if ((sim_clock == sim.last) || (sim_clock >= sim.ready)) {
+        if (sim.trace != NULL) {
+            sim_replay(dev);
+        } else {
+            sim_host(dev);
+        }
+    }
+    sim.last = sim_clock;
+    sim.cpu_mark = sim_cputime();
+}
+
+static void exithelp(void) {
+    printf("Usage: simulator [options] -i infile\n"
+           "\t infile is the fwcrypt output\n"
+           "\t -a appfile Raw application image in flash before the download\n"
+           "\t -o outfile Save the application flash at the end\n"
+           "\t -T tracefile Replay the recorded session instead of the download\n"
+           "\t -l tracefile Save the DFU_TRACE request trace at the end\n"
+           "\t -t us Host turnaround between the transfers (default 1000)\n"
+           "\t -n Don't send GETSTATUS after the blocks (DFU_DNLOAD_NOSYNC)\n"
+           "\t -u Upload the image after the download\n"
+           "\t -R Send DFU_DETACH at the end\n"
+           "\t -v Log every transfer\n"
+           "\t -h Show this help\n\n");
+    exit(1);
+}
+
+static uint8_t *sim_readfile(const char *name, size_t *length) {
+    FILE *fi = fopen(name, "rb");
+    if (fi == NULL) {
+        printf("Failed to open %s.\n", name);
+        exit(2);
+    }
+    fseek(fi, 0, SEEK_END);
+    *length = ftell(fi);
+    fseek(fi, 0, SEEK_SET);
+    uint8_t *buf = malloc(*length + 1);
+    if ((buf == NULL) || (fread(buf, 1, *length, fi) != *length)) {
+        printf("Failed to read %s.\n", name);
+        exit(3);
+    }
+    fclose(fi);
+    return buf;
+}
+
+int main(int argc, char **argv) {
+    char *infile = NULL;
+    char *appfile = NULL;
+    int opt;
+    sim.turnaround = 1000000;
+    while ((opt = getopt(argc, argv, "hi:a:o:T:l:t:nuRv")) != -1) {
+        switch (opt) {
+        case 'i':
+            infile = optarg;
+            break;
+        case 'a':
+            appfile = optarg;
+            break;
+        case 'o':
+            sim.outfile = optarg;
+            break;
+        case 'T':
+            sim_loadtrace(optarg);
+            break;
+        case 'l':
+            sim.logfile = optarg;
+            break;
+        case 't':
+            sim.turnaround = strtoul(optarg, NULL, 10) * 1000;
+            break;
+        case 'n':
+            sim.nosync = true;
+            break;
+        case 'u':
+            sim.upload = true;
+            break;
+        case 'R':
+            sim.detach = true;
+            break;
+        case 'v':
+            sim.verbose = true;
+            break;
+        default:
+            exithelp();
+        }
+    }
+    if (infile == NULL) {
+        exithelp();
+    }
+    sim.image = sim_readfile(infile, &sim.length);
+    /* DFU suffix is not sent */
+    if ((sim.length >= 16) && (memcmp(&sim.image[sim.length - 8], "UFD", 3) == 0)) {
+        sim.length -= sim.image[sim.length - 5];
+    }
+    sim_flash_init();
+    if (appfile != NULL) {
+        size_t applen;
+        uint8_t *app = sim_readfile(appfile, &applen);
+        if (applen > (size_t)(sim_rom + SIM_ROMLEN - &__app_start)) {
+            printf("Application doesn't fit the flash.\n");
+            exit(3);
+        }
+        memcpy(&__app_start, app, applen);
+        free(app);
+    }
+    /* DfuSe uses blocks 0 and 1 for the commands */
+    sim.block = 2;
+    sim.bState = USB_DFU_STATE_DFU_IDLE;
+    sim.cpu_mark = sim_cputime();
+    return bootloader_main();
+}
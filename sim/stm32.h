@@ -0,0 +1,36 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Host simulator replacement of the device header. Only the data EEPROM of
+ * STM32L0/L1 is used by the bootloader, it's placed in the flash model.
+ */
+
+#ifndef _STM32_H_
+#define _STM32_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(SIM_EELEN)
+    #define SIM_EELEN   0x800
+#endif
+
+#if defined(STM32L0) || defined(STM32L1)
+extern uint8_t sim_eeprom[];
+#define DATA_EEPROM_BASE    ((size_t)sim_eeprom)
+#define DATA_EEPROM_END     (DATA_EEPROM_BASE + SIM_EELEN - 1)
+#endif
+
+#endif // _STM32_H_
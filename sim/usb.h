@@ -0,0 +1,126 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Host simulator replacement of the usbd core. Standard definitions come
+ * from usb_std.h of the usb module, the device is driven by simulator.c
+ */
+
+#ifndef _USB_H_
+#define _USB_H_
+#if defined(__cplusplus)
+    extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "usb_std.h"
+
+#if !defined(INTSERIALNO_DESCRIPTOR)
+    #define INTSERIALNO_DESCRIPTOR  0xFE
+#endif
+
+#define USB_EPTYPE_CONTROL      0x00
+#define USB_EPTYPE_ISOCHRONUS   0x01
+#define USB_EPTYPE_BULK         0x02
+#define USB_EPTYPE_INTERRUPT    0x03
+
+enum {
+    usbd_evt_reset,
+    usbd_evt_sof,
+    usbd_evt_susp,
+    usbd_evt_wkup,
+    usbd_evt_eptx,
+    usbd_evt_eprx,
+    usbd_evt_epsetup,
+    usbd_evt_error,
+    usbd_evt_count,
+};
+
+typedef enum {
+    usbd_fail,
+    usbd_ack,
+    usbd_nak,
+} usbd_respond;
+
+typedef struct _usbd_device usbd_device;
+
+/** @brief Control request, data stage follows the header */
+typedef struct {
+    uint8_t     bmRequestType;
+    uint8_t     bRequest;
+    uint16_t    wValue;
+    uint16_t    wIndex;
+    uint16_t    wLength;
+    uint8_t     data[];
+} usbd_ctlreq;
+
+/** @brief Control transfer status */
+typedef struct {
+    void        *data_buf;
+    void        *data_ptr;
+    uint16_t    data_count;
+    uint16_t    data_maxsize;
+    uint8_t     ep0size;
+    uint8_t     device_cfg;
+} usbd_status;
+
+typedef void (*usbd_evt_callback)(usbd_device *dev, uint8_t event, uint8_t ep);
+typedef void (*usbd_rqc_callback)(usbd_device *dev, usbd_ctlreq *req);
+typedef usbd_respond (*usbd_ctl_callback)(usbd_device *dev, usbd_ctlreq *req, usbd_rqc_callback *callback);
+typedef usbd_respond (*usbd_dsc_callback)(usbd_ctlreq *req, void **address, uint16_t *dsize);
+typedef usbd_respond (*usbd_cfg_callback)(usbd_device *dev, uint8_t cfg);
+
+/** @brief Simulated peripheral. Endpoints other than EP0 are not modelled */
+struct usbd_driver {
+    const char  *name;
+};
+
+struct _usbd_device {
+    const struct usbd_driver    *driver;
+    usbd_ctl_callback           control_callback;
+    usbd_rqc_callback           complete_callback;
+    usbd_cfg_callback           config_callback;
+    usbd_dsc_callback           descriptor_callback;
+    usbd_evt_callback           events[usbd_evt_count];
+    usbd_evt_callback           endpoint[8];
+    usbd_status                 status;
+};
+
+extern const struct usbd_driver usbd_sim;
+#define usbd_hw usbd_sim
+
+void usbd_init(usbd_device *dev, const struct usbd_driver *drv, const uint8_t ep0size, uint32_t *buffer, const uint16_t bsize);
+void usbd_reg_control(usbd_device *dev, usbd_ctl_callback callback);
+void usbd_reg_config(usbd_device *dev, usbd_cfg_callback callback);
+void usbd_reg_descr(usbd_device *dev, usbd_dsc_callback callback);
+void usbd_reg_endpoint(usbd_device *dev, uint8_t ep, usbd_evt_callback callback);
+void usbd_reg_event(usbd_device *dev, uint8_t evt, usbd_evt_callback callback);
+void usbd_enable(usbd_device *dev, bool enable);
+void usbd_connect(usbd_device *dev, bool connect);
+bool usbd_ep_config(usbd_device *dev, uint8_t ep, uint8_t eptype, uint16_t epsize);
+void usbd_ep_deconfig(usbd_device *dev, uint8_t ep);
+int32_t usbd_ep_read(usbd_device *dev, uint8_t ep, void *buf, uint16_t blen);
+int32_t usbd_ep_write(usbd_device *dev, uint8_t ep, const void *buf, uint16_t blen);
+
+/**
+ * @brief Runs the host side of the simulation. Called from the bootloader main loop.
+ * @note Doesn't return when the host is done.
+ */
+void usbd_poll(usbd_device *dev);
+
+#if defined(__cplusplus)
+    }
+#endif
+#endif // _USB_H_
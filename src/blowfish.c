@@ -25,10 +25,25 @@
 
 #define rounds  16
 
+#if defined(BLOWFISH_ROMKEYS_P)
+static const struct {
+    uint32_t P[18];
+    uint32_t S[4][256];
+} D = {
+    {BLOWFISH_ROMKEYS_P},
+    {
+        {BLOWFISH_ROMKEYS_S0},
+        {BLOWFISH_ROMKEYS_S1},
+        {BLOWFISH_ROMKEYS_S2},
+        {BLOWFISH_ROMKEYS_S3},
+    },
+};
+#else
 static struct {
     uint32_t P[18];
     uint32_t S[4][256];
 } D;
+#endif
 
 static uint32_t F(uint32_t x) {
     uint32_t h = D.S[0][x >> 24] + D.S[1][(x >> 16) & 0xFF];
@@ -72,6 +87,9 @@ void blowfish_init(const void *key) {
  *  B. Schneier"
  * So, we will use pseudo random numbers fom xorshift
  */
+#if defined(BLOWFISH_ROMKEYS_P)
+    (void)key;
+#else
     uint32_t T[2] = {0,0};
     uint32_t S = 0xDEADBEEF;
     uint32_t *K = (uint32_t*)&D;
@@ -98,4 +116,5 @@ void blowfish_init(const void *key) {
             D.S[i][j+1] = T[1];
         }
     }
+#endif
 }
@@ -23,6 +23,10 @@
 #include "descriptors.h"
 #include "flash.h"
 #include "crypto.h"
+#include "checksum.h"
+#include "dfu_vendor.h"
+#include "patch.h"
+#include "bulk.h"
 
 /* Checking for the EEPROM */
 #if defined(DATA_EEPROM_BASE) && defined(DATA_EEPROM_END)
@@ -58,10 +62,65 @@
     #define _APP_LENGTH DFU_APP_SIZE
 #endif
 
-/* DFU request buffer size data + request header */
-#define DFU_BUFSZ  ((DFU_BLOCKSZ + 3 + 8) >> 2)
+/* Download region. With DFU_DUAL_BANK the image is written to the same offset
+ * of the inactive bank, which is always mapped to the upper half of the flash,
+ * and the banks are swapped on the reset after the image is verified.
+ */
+#if (DFU_DUAL_BANK == _ENABLE)
+    #if !defined(STM32L4) && !defined(STM32G4) && !defined(STM32F4)
+        #error DFU_DUAL_BANK requires STM32L4, STM32G4 or STM32F4. Check config !!
+    #elif defined(STM32G431xx)
+        #error STM32G431 has no dual bank flash. Check config !!
+    #elif (DFU_VERIFY_CHECKSUM == _DISABLE)
+        #error DFU_DUAL_BANK requires DFU_VERIFY_CHECKSUM. Check config !!
+    #endif
+    #define _ROM_START  ((size_t)&__romstart)
+    #define _BANK_SZ    (((size_t)&__romend - _ROM_START) >> 1)
+    #define _DFU_START  (_APP_START + _BANK_SZ)
+    #define _DFU_REGION (_ROM_START + _BANK_SZ - _APP_START)
+#else
+    #define _DFU_START  _APP_START
+    #define _DFU_REGION _APP_LENGTH
+#endif
+
+/* Verified image boot record. Kept at the end of EEPROM if present, or in the
+ * reserved vector table entries 0x20..0x27 of the application otherwise.
+ * Any DFU write to the application clears it.
+ */
+#if (DFU_BOOT_RECORD == _ENABLE)
+    #if (DFU_VERIFY_CHECKSUM == _DISABLE)
+        #error DFU_BOOT_RECORD requires DFU_VERIFY_CHECKSUM. Check config !!
+    #endif
+    #if defined(_EE_START)
+        #define _REC_ADDR       (_EE_START + _EE_LENGTH - sizeof(struct boot_record))
+        #define _REC_DFU        _REC_ADDR
+        #define _REC_WRITE      program_eeprom
+        #define _EE_RESERVED    sizeof(struct boot_record)
+    #else
+        #define _REC_ADDR       (_APP_START + 0x20)
+        #define _REC_DFU        (_DFU_START + 0x20)
+        #define _REC_WRITE      program_flash
+    #endif
+#endif
+
+#if !defined(_EE_RESERVED)
+    #define _EE_RESERVED    0
+#endif
+
+struct boot_record {
+    uint32_t    length;
+    uint32_t    digest;
+};
+
+#if (DFU_BLOCKSZ > 0x1000) || (DFU_BLOCKSZ & 0x03)
+    #error DFU_BLOCKSZ must be a multiple of 4 up to 4096 bytes. Check config !!
+#endif
+
+/* DFU request buffer size data + tag + request header */
+#define DFU_BUFSZ  ((DFU_BLOCKSZ + DFU_TAGSZ + 3 + 8) >> 2)
 
 extern uint8_t  __app_start;
+extern uint8_t  __romstart;
 extern uint8_t  __romend;
 
 static uint32_t dfu_buffer[DFU_BUFSZ];
@@ -74,25 +133,608 @@ static struct dfu_data_s {
     uint8_t     interface;
     uint8_t     bStatus;
     uint8_t     bState;
+#if (DFU_PATCH == _ENABLE)
+    uint8_t     patch;
+#endif
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+    uint8_t     manifest;   /* manifestation waits for the staged blocks */
+    uint8_t     flush;      /* dfuDNBUSY until the staged blocks are programmed */
+#endif
+#if (DFU_DFUSE == _ENABLE)
+    size_t      next;       /* address the host expects the next block at */
+    uint8_t     targeted;   /* image is not written from the start in one piece */
+    uint8_t     command;    /* DfuSe command is reported as dfuDNBUSY once */
+    uint8_t     moved;      /* pointer was moved mid-page, checked by the next block */
+#endif
+#if (DFU_DUAL_BANK == _ENABLE)
+    uint8_t     swap;       /* verified image in the inactive bank */
+#endif
+#if (DFU_RESUME == _ENABLE)
+    uint32_t    image;      /* journaled image id, 0 if the download is not journaled */
+    size_t      jrn_offset; /* last recorded offset */
+#endif
 } dfu_data;
 
+#if (DFU_BULK == _ENABLE)
+/* bulk transport. See bulk.h */
+static struct dfu_bulk_s {
+    uint32_t        block[(DFU_BLOCKSZ + DFU_TAGSZ + 3) >> 2];
+    uint32_t        pkt[BULK_EP_SIZE >> 2];
+    uint8_t         pktpos;     /* packet data passed to the collector */
+    uint8_t         pktlen;
+    struct bulk_rx  rx;
+    struct bulk_ack ack[BULK_WINDOW];
+    uint8_t         head;
+    uint8_t         count;      /* acks waiting for the IN endpoint */
+    bool            txbusy;
+    bool            rxpend;     /* OUT packet is left in the endpoint */
+} dfu_bulk;
+#endif
+
+/* Flash geometry and typical datasheet timings. _PAGE_SZ is the largest
+ * erase page of the family or 0 for the sectored flash, _PAGE_MIN is the
+ * smallest one, _PROG_SZ is the programming unit of program_flash(),
+ * _ERASE_MS is the page erase time and _PROG_MS_KB is the time to program 1KiB.
+ * _ERASED_BYTE is the value of the erased flash.
+ */
+#if defined(STM32L0)
+    #define _PAGE_SZ        0x80
+    #define _PAGE_MIN       0x80
+    #define _PROG_SZ        0x40
+    #define _ERASED_BYTE    0x00
+    #define _ERASE_MS       4
+    #define _PROG_MS_KB     52
+#elif defined(STM32L1)
+    #define _PAGE_SZ        0x100
+    #define _PAGE_MIN       0x100
+    #define _PROG_SZ        0x80
+    #define _ERASED_BYTE    0x00
+    #define _ERASE_MS       4
+    #define _PROG_MS_KB     26
+#elif defined(STM32F0) || defined(STM32F1) || defined(STM32F3)
+    #define _PAGE_SZ        0x800
+    #define _PAGE_MIN       0x400
+    #define _PROG_SZ        0x02
+    #define _ERASE_MS       20
+    #define _PROG_MS_KB     27
+#elif defined(STM32L4)
+    #define _PAGE_SZ        0x800
+    #define _PAGE_MIN       0x800
+    #define _PROG_SZ        0x08
+    #define _ERASE_MS       22
+    #define _PROG_MS_KB     11
+#elif defined(STM32G4)
+    #if defined(STM32G431xx)
+        #define _PAGE_SZ    0x800
+    #else
+        #define _PAGE_SZ    0x1000
+    #endif
+    #define _PAGE_MIN       0x800
+    #define _PROG_SZ        0x08
+    #define _ERASE_MS       22
+    #define _PROG_MS_KB     11
+#elif defined(STM32F4)
+    /* 16K, 64K and 128K sectors. See dfu_erase_time() */
+    #define _PAGE_SZ        0
+    #define _PROG_MS_KB     4
+#else
+    #define _PAGE_SZ        0
+    #define _ERASE_MS       DFU_POLL_TIMEOUT
+    #define _PROG_MS_KB     0
+#endif
+#if !defined(_ERASED_BYTE)
+    #define _ERASED_BYTE    0xFF
+#endif
+/* 3.2ms per word on STM32L0/L1 data EEPROM */
+#define _EE_PROG_MS_KB      820
+
+/* Download progress journal. Kept below the boot record in EEPROM if present,
+ * or in the last page of the download region otherwise. The offset is
+ * recorded every _JRN_STEP bytes of the journaled download.
+ */
+#if (DFU_RESUME == _ENABLE)
+    #if (DFU_VERIFY_CHECKSUM == _DISABLE)
+        #error DFU_RESUME requires DFU_VERIFY_CHECKSUM. Check config !!
+    #endif
+    #if defined(_EE_START)
+        #define _EE_JOURNAL     sizeof(struct dfu_vendor_journal)
+        #define _JRN_ADDR       (_EE_START + _EE_LENGTH - _EE_RESERVED - _EE_JOURNAL)
+    #elif (_PAGE_SZ == 0)
+        #error DFU_RESUME requires EEPROM or page erased flash. Check config !!
+    #else
+        #define _JRN_RESERVED   _PAGE_SZ
+        #define _JRN_ADDR       (_DFU_START + _DFU_LENGTH)
+    #endif
+    #define _JRN_STEP           0x1000
+    #define _VENDOR_ENABLED
+#endif
+
+#if !defined(_EE_JOURNAL)
+    #define _EE_JOURNAL     0
+#endif
+#if !defined(_JRN_RESERVED)
+    #define _JRN_RESERVED   0
+#endif
+#define _DFU_LENGTH         (_DFU_REGION - _JRN_RESERVED)
+
+#if (DFU_SKIP_ERASED == _ENABLE)
+    #if (_PAGE_SZ == 0)
+        #error DFU_SKIP_ERASED requires page erased flash. Check config !!
+    #endif
+    #define _FLASH_PROG     program_sparse
+#else
+    #define _FLASH_PROG     program_flash
+#endif
+
+#if (DFU_SKIP_UNCHANGED == _ENABLE)
+    #if (_PAGE_SZ == 0)
+        #error DFU_SKIP_UNCHANGED requires page erased flash. Check config !!
+    #elif (DFU_BLOCKSZ % _PAGE_SZ)
+        /* only the pages covered by one block are compared */
+        #error DFU_SKIP_UNCHANGED requires DFU_BLOCKSZ multiple of the flash page. Check config !!
+    #endif
+    #define _VENDOR_ENABLED
+    #define _FLASH_WRITE    program_diff
+#else
+    #define _FLASH_WRITE    _FLASH_PROG
+#endif
+
+#if (DFU_DIGEST == _ENABLE)
+    #if (DFU_VERIFY_CHECKSUM == _DISABLE)
+        #error DFU_DIGEST requires DFU_VERIFY_CHECKSUM. Check config !!
+    #endif
+    #define _VENDOR_ENABLED
+#endif
+
+#if (DFU_TRACE == _ENABLE)
+    #if (DFU_TRACE_DEPTH < 1) || (DFU_TRACE_DEPTH > 0x1000)
+        #error DFU_TRACE_DEPTH must be 1 to 4096 entries. Check config !!
+    #endif
+    #define _VENDOR_ENABLED
+#endif
+
+#if (DFU_PATCH == _ENABLE)
+    #if (_PAGE_SZ == 0)
+        #error DFU_PATCH requires page erased flash. Check config !!
+    #endif
+    /* the window is a whole number of pages, 1KiB at least */
+    #if (_PAGE_SZ > 0x400)
+        #define _PATCH_WINDOW   _PAGE_SZ
+    #else
+        #define _PATCH_WINDOW   0x400
+    #endif
+#endif
+
+#if (DFU_DFUSE == _ENABLE)
+    #if (_PAGE_SZ == 0)
+        #error DFU_DFUSE requires page erased flash. Check config !!
+    #endif
+    #if (DFU_BOOT_RECORD == _ENABLE) && !defined(_EE_START)
+        #error DFU_DFUSE requires the boot record in EEPROM. Check config !!
+    #endif
+    #define DFUSE_GET_COMMANDS      0x00
+    #define DFUSE_SET_ADDRESS       0x21
+    #define DFUSE_ERASE             0x41
+    #define DFUSE_READ_UNPROTECT    0x92
+#endif
+
+#if (DFU_SKIP_ERASED == _ENABLE) || (DFU_DFUSE == _ENABLE)
+/** Returns true if the data is all erased flash value */
+static bool dfu_erased(const uint8_t *data, size_t sz) {
+    while (sz--) {
+        if (*data++ != _ERASED_BYTE) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+#if (DFU_SKIP_ERASED == _ENABLE)
+/** Programs the block skipping the erased data. The first unit of every
+ * page is always written, it erases the page.
+ */
+static uint8_t program_sparse(void *romptr, const void *buf, size_t blksize) {
+    uint8_t *rom = romptr;
+    const uint8_t *data = buf;
+    size_t run = 0;
+    if ((size_t)romptr & (_PROG_SZ - 1)) {
+        return program_flash(romptr, buf, blksize);
+    }
+    for (size_t pos = 0; pos < blksize; pos += _PROG_SZ) {
+        size_t sz = (blksize - pos < _PROG_SZ) ? blksize - pos : _PROG_SZ;
+        if (((size_t)&rom[pos] & (_PAGE_MIN - 1)) && dfu_erased(&data[pos], sz)) {
+            if (run != 0) {
+                uint8_t status = program_flash(&rom[pos - run], &data[pos - run], run);
+                if (status != USB_DFU_STATUS_OK) {
+                    return status;
+                }
+            }
+            run = 0;
+        } else {
+            run += sz;
+        }
+    }
+    if (run != 0) {
+        return program_flash(&rom[blksize - run], &data[blksize - run], run);
+    }
+    return USB_DFU_STATUS_OK;
+}
+#endif
+
+#if (DFU_SKIP_UNCHANGED == _ENABLE)
+static struct dfu_vendor_stats dfu_stats;
+
+/** Returns _PAGE_SZ if the block covers the whole page and it's unchanged */
+static size_t dfu_skip_page(const void *romptr, const void *buf, size_t blksize) {
+    const uint32_t *rom = romptr;
+    const uint32_t *data = buf;
+    if (((size_t)romptr & (_PAGE_SZ - 1)) || (blksize < _PAGE_SZ)) {
+        return 0;
+    }
+    for (size_t i = 0; i < _PAGE_SZ / 4; i++) {
+        if (rom[i] != data[i]) {
+            return 0;
+        }
+    }
+    dfu_stats.dwPagesSkipped++;
+    return _PAGE_SZ;
+}
+
+/** Programs flash page by page. Pages that already hold the data are not
+ * erased and programmed.
+ */
+static uint8_t program_diff(void *romptr, const void *buf, size_t blksize) {
+    while (blksize) {
+        size_t sz = dfu_skip_page(romptr, buf, blksize);
+        if (sz == 0) {
+            sz = _PAGE_SZ - ((size_t)romptr & (_PAGE_SZ - 1));
+            if (sz == _PAGE_SZ) {
+                dfu_stats.dwPagesProgrammed++;
+            }
+            if (sz > blksize) {
+                sz = blksize;
+            }
+            uint8_t status = _FLASH_PROG(romptr, buf, sz);
+            if (status != USB_DFU_STATUS_OK) {
+                return status;
+            }
+        }
+        romptr += sz;
+        buf += sz;
+        blksize -= sz;
+    }
+    return USB_DFU_STATUS_OK;
+}
+#endif
+
+#if (DFU_RESUME == _ENABLE)
+static struct dfu_vendor_journal dfu_journal;
+
+#if defined(_EE_START)
+static void dfu_journal_read(struct dfu_vendor_journal *jrn) {
+    *jrn = *(const struct dfu_vendor_journal*)_JRN_ADDR;
+}
+
+static void dfu_journal_write(uint32_t id, size_t offset) {
+    const uint32_t jrn[2] = {id, offset};
+    program_eeprom((void*)_JRN_ADDR, jrn, sizeof(jrn));
+}
+#else
+/* Entries are appended to the first _PAGE_MIN bytes of the journal page, the
+ * last one is current. The page is erased when the first slot is written.
+ */
+#define _JRN_SLOTS  (_PAGE_MIN / sizeof(struct dfu_vendor_journal))
+
+/** Returns the index of the first erased slot */
+static size_t dfu_journal_next(void) {
+    const struct dfu_vendor_journal *slot = (const void*)_JRN_ADDR;
+    size_t n = 0;
+    while ((n < _JRN_SLOTS) && ((slot[n].dwImageId != 0xFFFFFFFF) || (slot[n].dwOffset != 0xFFFFFFFF))) {
+        n++;
+    }
+    return n;
+}
+
+static void dfu_journal_read(struct dfu_vendor_journal *jrn) {
+    const struct dfu_vendor_journal *slot = (const void*)_JRN_ADDR;
+    size_t n = dfu_journal_next();
+    if (n == 0) {
+        jrn->dwImageId = 0;
+        jrn->dwOffset = 0;
+    } else {
+        *jrn = slot[n - 1];
+    }
+}
+
+static void dfu_journal_write(uint32_t id, size_t offset) {
+    const uint32_t jrn[2] = {id, offset};
+    size_t n = dfu_journal_next();
+    if (n == _JRN_SLOTS) {
+        n = 0;
+    }
+    program_flash((void*)(_JRN_ADDR + n * sizeof(jrn)), jrn, sizeof(jrn));
+}
+#endif
+
+/** Returns the stored journal. Torn or foreign entries read as no journal */
+static struct dfu_vendor_journal *dfu_journal_get(void) {
+    dfu_journal_read(&dfu_journal);
+    if ((dfu_journal.dwImageId == 0xFFFFFFFF) || (dfu_journal.dwOffset > _DFU_LENGTH) ||
+        (dfu_journal.dwOffset % DFU_BLOCKSZ)) {
+        dfu_journal.dwImageId = 0;
+        dfu_journal.dwOffset = 0;
+    }
+    return &dfu_journal;
+}
+
+/** Stops journaling and clears the stored journal */
+static void dfu_journal_drop(void) {
+    dfu_data.image = 0;
+    if (dfu_journal_get()->dwImageId != 0) {
+        dfu_journal_write(0, 0);
+    }
+}
+
+/* Records the programmed part of the journaled download. Write errors are
+ * not reported, the resumed image is verified by the checksum anyway.
+ */
+static void dfu_journal_update(size_t offset) {
+    if ((dfu_data.image != 0) && ((offset % DFU_BLOCKSZ) == 0) &&
+        ((offset / _JRN_STEP) != (dfu_data.jrn_offset / _JRN_STEP))) {
+        dfu_data.jrn_offset = offset;
+        dfu_journal_write(dfu_data.image, offset);
+    }
+}
+#endif
+
+#if (DFU_DFUSE == _ENABLE)
+/* program_flash() erases the page only when its first unit is written, so
+ * the rest of the page must be already erased by the host
+ */
+static uint8_t dfu_check_moved(size_t addr) {
+    if (!dfu_erased((const uint8_t*)addr, _PAGE_SZ - (addr & (_PAGE_SZ - 1)))) {
+        return USB_DFU_STATUS_ERR_ADDRESS;
+    }
+    return USB_DFU_STATUS_OK;
+}
+
+/* DfuSe Erase. Writes the erased value to the first unit of every page in the range */
+static uint8_t dfu_erase_range(void *romptr, const void *buf, size_t blksize) {
+    uint8_t erased[_PROG_SZ] __attribute__((aligned(4)));
+    size_t addr = ((size_t)romptr + _PAGE_MIN - 1) & ~(size_t)(_PAGE_MIN - 1);
+    (void)buf;
+    for (size_t i = 0; i < _PROG_SZ; i++) {
+        erased[i] = _ERASED_BYTE;
+    }
+    for (; addr < (size_t)romptr + blksize; addr += _PAGE_MIN) {
+        uint8_t status = program_flash((void*)addr, erased, _PROG_SZ);
+        if (status != USB_DFU_STATUS_OK) {
+            return status;
+        }
+    }
+    return USB_DFU_STATUS_OK;
+}
+#endif
+
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+/* Programming step. Multiple of the largest write unit (STM32L1 halfpage) */
+#define _STEP_SZ            0x80
+
+/* Downloaded blocks are decrypted to the staging buffers and programmed by
+ * dfu_step() from the main loop. Next block is received and decrypted while
+ * the previous one is programmed. dfu_job[dfu_head] is programmed first.
+ */
+static uint32_t dfu_block[2][(DFU_BLOCKSZ + 3) >> 2];
+
+static struct dfu_job_s {
+    uint8_t     (*flash)(void *romptr, const void *buf, size_t blksize);
+    void        *dptr;
+    const void  *sptr;
+    size_t      remained;
+#if (DFU_DFUSE == _ENABLE)
+    uint8_t     moved;      /* started mid-page, see dfu_check_moved() */
+#endif
+} dfu_job[2];
+
+static uint8_t dfu_head;
+
+#if defined(STM32F4)
+/* Sector erase runs while the main loop keeps polling USB. The CPU still
+ * stalls on the flash reads from the bank being erased.
+ */
+static uint8_t dfu_erasing;
+/* sector start whose erase time is already reported in bwPollTimeout */
+static size_t dfu_erase_reported;
+#endif
+
+/** Returns erase time (ms) if the address is the start of the erase unit */
+static uint32_t dfu_erase_time(size_t addr) {
+#if defined(STM32F4)
+    /* sectors 0-3 of the bank are 16K, 4 is 64K, the rest are 128K */
+    uint8_t snb = flash_sector((void*)addr);
+    if (snb == 0) return 0;
+    snb = (snb >> 3) & 0x0F;
+    if (snb < 4) return 500;
+    if (snb < 5) return 1100;
+    return 2000;
+#elif (_PAGE_SZ != 0)
+    return (addr & (_PAGE_SZ - 1)) ? 0 : _ERASE_MS;
+#else
+    (void)addr;
+    return _ERASE_MS;
+#endif
+}
+
+/** Estimates time (ms) to complete the job */
+static uint32_t dfu_poll_timeout(const struct dfu_job_s *job) {
+    uint32_t timeout = 1;
+#if defined(_EEPROM_ENABLED)
+    if (job->flash == program_eeprom) {
+        return timeout + ((job->remained * _EE_PROG_MS_KB) >> 10);
+    }
+#endif
+    for (size_t offs = 0; offs < job->remained; offs += _STEP_SZ) {
+        size_t addr = (size_t)job->dptr + offs;
+        uint32_t erase = dfu_erase_time(addr);
+#if defined(STM32F4)
+        /* the host has waited for it already, the erase runs in the background */
+        if (erase != 0) {
+            if (addr == dfu_erase_reported) {
+                erase = 0;
+            }
+            dfu_erase_reported = addr;
+        }
+#endif
+        timeout += erase;
+    }
+#if (DFU_DFUSE == _ENABLE)
+    if (job->flash == dfu_erase_range) {
+        return timeout;
+    }
+#endif
+    return timeout + ((job->remained * _PROG_MS_KB) >> 10);
+}
+
+static void dfu_cancel(void) {
+    dfu_job[0].remained = 0;
+    dfu_job[1].remained = 0;
+    dfu_data.manifest = 0;
+    dfu_data.flush = 0;
+#if defined(STM32F4)
+    /* the erase is finished by the next flash operation */
+    dfu_erasing = 0;
+    dfu_erase_reported = 0;
+#endif
+}
+
+/** Returns free staging slot or NULL if both are pending */
+static struct dfu_job_s *dfu_free_job(void) {
+    if (dfu_job[dfu_head].remained == 0) {
+        return &dfu_job[dfu_head];
+    }
+    if (dfu_job[dfu_head ^ 1].remained == 0) {
+        return &dfu_job[dfu_head ^ 1];
+    }
+    return NULL;
+}
+
+/** Programs the next step of the pending job. Called from the main loop */
+static void dfu_step(void) {
+    struct dfu_job_s *job = &dfu_job[dfu_head];
+    if (job->remained == 0) {
+        return;
+    }
+    size_t sz = 0;
+    uint8_t (*flash)(void *romptr, const void *buf, size_t blksize) = job->flash;
+#if (DFU_DFUSE == _ENABLE)
+    /* the blocks staged before have reached the flash */
+    if (job->moved) {
+        job->moved = 0;
+        uint8_t status = dfu_check_moved((size_t)job->dptr);
+        if (status != USB_DFU_STATUS_OK) {
+            dfu_cancel();
+            dfu_data.bStatus = status;
+            dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+            return;
+        }
+    }
+#endif
+#if defined(STM32F4)
+    /* the sector erase is a step of its own */
+    if (dfu_erasing) {
+        uint8_t status = flash_status();
+        if (status == FLASH_BUSY) {
+            return;
+        }
+        dfu_erasing = 0;
+        if (status != USB_DFU_STATUS_OK) {
+            dfu_cancel();
+            dfu_data.bStatus = status;
+            dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+            return;
+        }
+        flash = program_erased;
+    } else if ((flash == program_flash) && erase_sector(job->dptr)) {
+        dfu_erasing = 1;
+        return;
+    }
+#endif
+#if (DFU_SKIP_UNCHANGED == _ENABLE)
+    /* unchanged page is skipped in one step */
+    if (flash == program_diff) {
+        sz = dfu_skip_page(job->dptr, job->sptr, job->remained);
+    }
+#endif
+    if (sz == 0) {
+        sz = (job->remained < _STEP_SZ) ? job->remained : _STEP_SZ;
+#if defined(STM32F4)
+        /* the step ends at the 16K boundary, the next one may start the erase */
+        if (sz > 0x4000 - ((size_t)job->dptr & 0x3FFF)) {
+            sz = 0x4000 - ((size_t)job->dptr & 0x3FFF);
+        }
+#endif
+        uint8_t status = flash(job->dptr, job->sptr, sz);
+        if (status != USB_DFU_STATUS_OK) {
+            dfu_cancel();
+            dfu_data.bStatus = status;
+            dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+            return;
+        }
+    }
+    job->dptr += sz;
+    job->sptr += sz;
+    job->remained -= sz;
+    if (job->remained == 0) {
+        dfu_head ^= 1;
+#if (DFU_RESUME == _ENABLE)
+        dfu_journal_update((size_t)job->dptr - _DFU_START);
+#endif
+    }
+}
+#endif
+
 /** Processing DFU_SET_IDLE request */
 static usbd_respond dfu_set_idle(void) {
-    aes_init();
+    aes_reset();
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+    dfu_cancel();
+#endif
+#if (DFU_VERIFY_CHECKSUM != _DISABLE)
+    checksum_init();
+#endif
     dfu_data.bState = USB_DFU_STATE_DFU_IDLE;
     dfu_data.bStatus = USB_DFU_STATUS_OK;
+#if (DFU_PATCH == _ENABLE)
+    dfu_data.patch = 0;
+#endif
+#if (DFU_DFUSE == _ENABLE)
+    dfu_data.next = _DFU_START;
+    dfu_data.targeted = 0;
+    dfu_data.command = 0;
+    dfu_data.moved = 0;
+#endif
+#if (DFU_RESUME == _ENABLE)
+    dfu_data.image = 0;
+#endif
+#if (DFU_BULK == _ENABLE)
+    /* partial block is dropped by DFU_ABORT */
+    bulk_rx_init(&dfu_bulk.rx, dfu_bulk.block, sizeof(dfu_bulk.block));
+    dfu_bulk.pktpos = 0;
+    dfu_bulk.pktlen = 0;
+#endif
     switch (dfu_data.interface){
 #if defined(_EEPROM_ENABLED)
     case 1:
         dfu_data.dptr = (void*)_EE_START;
-        dfu_data.remained = _EE_LENGTH;
+        dfu_data.remained = _EE_LENGTH - _EE_RESERVED - _EE_JOURNAL;
         dfu_data.flash = program_eeprom;
         break;
 #endif
     default:
-        dfu_data.dptr = (void*)_APP_START;
-        dfu_data.remained = _APP_LENGTH;
-        dfu_data.flash = program_flash;
+        dfu_data.dptr = (void*)_DFU_START;
+        dfu_data.remained = _DFU_LENGTH;
+        dfu_data.flash = _FLASH_WRITE;
         break;
     }
     return usbd_ack;
@@ -100,7 +742,87 @@ static usbd_respond dfu_set_idle(void) {
 
 extern void System_Reset(void);
 
+#if (DFU_VERIFY_CHECKSUM != _DISABLE)
+/* first word of the stored digest. may be unaligned */
+static uint32_t get_digest(const uint8_t *digest) {
+    return digest[0] | digest[1] << 8 | digest[2] << 16 | (uint32_t)digest[3] << 24;
+}
+
+/* Called by the startup code. .data and .bss are not initialized yet. */
+size_t validate_firmware(const void *data, size_t bsize) {
+#if (DFU_BOOT_RECORD == _ENABLE)
+    const struct boot_record *rec = (const void*)_REC_ADDR;
+    size_t length = checksum_image_length(data, bsize);
+    if ((length != 0) && (rec->length == length) &&
+        (rec->digest == get_digest((const uint8_t*)data + length))) {
+        return length;
+    }
+#endif
+    return validate_checksum(data, bsize);
+}
+#endif
+
+#if (DFU_BOOT_RECORD == _ENABLE)
+static void dfu_clear_record(void) {
+#if defined(_EE_START)
+    static const struct boot_record none = {0, 0};
+    const struct boot_record *rec = (const void*)_REC_ADDR;
+    if ((rec->length != 0) || (rec->digest != 0)) {
+        program_eeprom((void*)_REC_ADDR, &none, sizeof(none));
+    }
+#endif
+    /* flash record is erased with the first application page */
+}
+
+static void dfu_write_record(size_t length) {
+    const struct boot_record *old = (const void*)_REC_DFU;
+    struct boot_record rec;
+    rec.length = length;
+    rec.digest = get_digest((uint8_t*)_DFU_START + length);
+    if ((old->length != rec.length) || (old->digest != rec.digest)) {
+        _REC_WRITE((void*)_REC_DFU, &rec, sizeof(rec));
+    }
+}
+#endif
+
+#if (DFU_PATCH == _ENABLE)
+/* new data is assembled here while the old one is still in flash */
+static uint32_t dfu_window[_PATCH_WINDOW >> 2];
+
+/* writes the window assembled by the patch decoder */
+static uint8_t dfu_patch_write(size_t offset, const void *data, size_t len) {
+    uint8_t *romptr = (uint8_t*)_DFU_START + offset;
+    uint8_t res = _FLASH_WRITE(romptr, data, len);
+    if (res == USB_DFU_STATUS_OK) {
+#if (DFU_VERIFY_CHECKSUM != _DISABLE)
+        checksum_update(data, len);
+#endif
+        dfu_data.dptr = romptr + len;
+        dfu_data.remained = _DFU_LENGTH - offset - len;
+    }
+    return res;
+}
+
+/* the patch is applied only over the firmware it was made for */
+static void dfu_patch_start(void) {
+    size_t length = 0;
+    uint32_t digest = 0;
+#if (DFU_VERIFY_CHECKSUM != _DISABLE)
+    length = validate_checksum((void*)_APP_START, _DFU_LENGTH);
+    if (length != 0) {
+        digest = get_digest((uint8_t*)_APP_START + length);
+    }
+#endif
+    /* with DFU_DUAL_BANK the old image is in the active bank */
+    patch_init((void*)_APP_START, (void*)_DFU_START, _DFU_LENGTH, dfu_window, _PATCH_WINDOW, length, digest, dfu_patch_write);
+    dfu_data.patch = 1;
+}
+#endif
+
 static usbd_respond dfu_err_badreq(void) {
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+    dfu_cancel();
+#endif
     dfu_data.bState  = USB_DFU_STATE_DFU_ERROR;
     dfu_data.bStatus = USB_DFU_STATUS_ERR_STALLEDPKT;
     return usbd_fail;
@@ -114,11 +836,13 @@ static usbd_respond dfu_upload(usbd_device *dev, size_t blksize) {
         if (dfu_data.remained == 0) {
             dev->status.data_count = 0;
             return dfu_set_idle();
-        } else if (dfu_data.remained < DFU_BLOCKSZ) {
+        }
+        /* room for the tag */
+        blksize = (blksize > DFU_TAGSZ) ? blksize - DFU_TAGSZ : 0;
+        if (dfu_data.remained < blksize) {
             blksize = dfu_data.remained;
         }
-        aes_encrypt(dev->status.data_ptr, dfu_data.dptr, blksize);
-        dev->status.data_count = blksize;
+        dev->status.data_count = aes_seal(dev->status.data_ptr, dfu_data.dptr, blksize);
         dfu_data.remained -= blksize;
         dfu_data.dptr += blksize;
         return usbd_ack;
@@ -126,29 +850,343 @@ static usbd_respond dfu_upload(usbd_device *dev, size_t blksize) {
         return dfu_err_badreq();
     }
 }
+
+#if (DFU_DFUSE == _ENABLE)
+/* DfuSe Get Commands is the upload of the block 0 */
+static usbd_respond dfu_dfuse_commands(usbd_device *dev, size_t blksize) {
+    static const uint8_t commands[] = {
+        DFUSE_GET_COMMANDS, DFUSE_SET_ADDRESS, DFUSE_ERASE, DFUSE_READ_UNPROTECT,
+    };
+    if (dfu_data.bState != USB_DFU_STATE_DFU_IDLE) {
+        return dfu_err_badreq();
+    }
+    dev->status.data_ptr = (void*)commands;
+    dev->status.data_count = (blksize < sizeof(commands)) ? blksize : sizeof(commands);
+    return usbd_ack;
+}
+#endif
+#endif
+
+#if (DFU_DUAL_BANK == _ENABLE)
+/* the device boots from the start of the other bank after the swap */
+static uint8_t dfu_copy_loader(void) {
+    const uint32_t *src = (const uint32_t*)_ROM_START;
+    const uint32_t *dst = (const uint32_t*)(_ROM_START + _BANK_SZ);
+    size_t len = _APP_START - _ROM_START;
+    for (size_t i = 0; i < (len >> 2); i++) {
+        if (src[i] != dst[i]) {
+            return program_flash((void*)dst, src, len);
+        }
+    }
+    return USB_DFU_STATUS_OK;
+}
 #endif
 
-static usbd_respond dfu_dnload(void *buf, size_t blksize) {
+/* Processing zero-length DFU_DNLOAD. Downloaded image is checked while the
+ * host is still connected. Flash contents was verified against the data
+ * by the programming routine, so the streamed checksum matches the flash.
+ */
+static usbd_respond dfu_manifest(void) {
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+    /* staged blocks must be in flash before the boot record is written.
+     * GETSTATUS reports dfuMANIFEST until the main loop completes it
+     */
+    dfu_data.manifest = (dfu_job[dfu_head].remained != 0);
+    if (dfu_data.manifest) {
+        dfu_data.bState = USB_DFU_STATE_DFU_MANIFESTSYNC;
+        return usbd_ack;
+    }
+#endif
+#if (DFU_PATCH == _ENABLE)
+    if (dfu_data.patch) {
+        /* last part is still in the window */
+        dfu_data.bStatus = patch_final();
+        if (dfu_data.bStatus != USB_DFU_STATUS_OK) {
+            dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+            return usbd_ack;
+        }
+    }
+#endif
+#if (DFU_VERIFY_CHECKSUM != _DISABLE)
+    bool written = (dfu_data.dptr != (void*)_DFU_START);
+#if (DFU_DFUSE == _ENABLE)
+    written = written || dfu_data.targeted;
+#endif
+    if ((dfu_data.interface == 0) && written) {
+        size_t length = checksum_final();
+#if (DFU_DFUSE == _ENABLE)
+        if (dfu_data.targeted) {
+            /* written in parts, the whole region is checked */
+            length = validate_checksum((void*)_DFU_START, _DFU_LENGTH);
+        }
+#endif
+        if (length == 0) {
+            dfu_data.bStatus = USB_DFU_STATUS_ERR_VERIFY;
+            dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+            return usbd_ack;
+        }
+#if (DFU_BOOT_RECORD == _ENABLE)
+        dfu_write_record(length);
+#endif
+#if (DFU_DUAL_BANK == _ENABLE)
+        /* the old image stays bootable if anything fails before the swap */
+        dfu_data.bStatus = dfu_copy_loader();
+        if (dfu_data.bStatus != USB_DFU_STATUS_OK) {
+            dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+            return usbd_ack;
+        }
+        dfu_data.swap = 1;
+#endif
+#if (DFU_RESUME == _ENABLE)
+        dfu_journal_drop();
+#endif
+    }
+#endif
+    dfu_data.bState = USB_DFU_STATE_DFU_MANIFESTSYNC;
+    return usbd_ack;
+}
+
+#if (DFU_DFUSE == _ENABLE)
+/* moves the flash pointer. The stream is continued if it is already there */
+static uint8_t dfu_set_address(size_t addr) {
+    if (addr == dfu_data.next) {
+        /* dfu-util sets the address before every chunk */
+        return USB_DFU_STATUS_OK;
+    }
+#if (DFU_PATCH == _ENABLE)
+    if (dfu_data.patch) {
+        return USB_DFU_STATUS_ERR_ADDRESS;
+    }
+#endif
+    dfu_data.dptr = (void*)addr;
+    dfu_data.remained = _DFU_START + _DFU_LENGTH - addr;
+    dfu_data.next = addr;
+    dfu_data.targeted = 1;
+    dfu_data.moved = (addr & (_PAGE_SZ - 1)) ? 1 : 0;
+    return USB_DFU_STATUS_OK;
+}
+
+/* erases the page at addr. With DFU_DNLOAD_ASYNC it's queued after the staged blocks */
+static uint8_t dfu_erase_page(size_t addr) {
+    addr &= ~(size_t)(_PAGE_SZ - 1);
+    if ((addr < _DFU_START) || (addr >= _DFU_START + _DFU_LENGTH)) {
+        return USB_DFU_STATUS_ERR_TARGET;
+    }
+#if (DFU_PATCH == _ENABLE)
+    if (dfu_data.patch) {
+        return USB_DFU_STATUS_ERR_TARGET;
+    }
+#endif
+    dfu_data.targeted = 1;
+#if (DFU_BOOT_RECORD == _ENABLE)
+    dfu_clear_record();
+#endif
+#if (DFU_RESUME == _ENABLE)
+    dfu_journal_drop();
+#endif
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+    struct dfu_job_s *job = dfu_free_job();
+    job->flash = dfu_erase_range;
+    job->dptr = (void*)addr;
+    job->sptr = (void*)addr;
+    job->remained = _PAGE_SZ;
+    job->moved = 0;
+    return USB_DFU_STATUS_OK;
+#else
+    return dfu_erase_range((void*)addr, NULL, _PAGE_SZ);
+#endif
+}
+
+/* DfuSe commands are sent unencrypted in the DFU_DNLOAD block 0 */
+static usbd_respond dfu_dfuse(const uint8_t *cmd, size_t len) {
+    uint8_t status = USB_DFU_STATUS_ERR_TARGET;
+    size_t addr = 0;
+    if (len == 5) {
+        addr = cmd[1] | cmd[2] << 8 | cmd[3] << 16 | (uint32_t)cmd[4] << 24;
+    }
+    switch (cmd[0]) {
+    case DFUSE_SET_ADDRESS:
+        if ((len == 5) && (dfu_data.interface == 0) &&
+            (addr >= _DFU_START) && (addr < _DFU_START + _DFU_LENGTH)) {
+            status = dfu_set_address(addr);
+        }
+        break;
+    case DFUSE_ERASE:
+        /* no mass erase, it would take the bootloader too */
+        if ((len == 5) && (dfu_data.interface == 0)) {
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+            if (dfu_free_job() == NULL) {
+                return dfu_err_badreq();
+            }
+#endif
+            status = dfu_erase_page(addr);
+        }
+        break;
+    case DFUSE_READ_UNPROTECT:
+        /* readout protection is not changed by the bootloader */
+        status = USB_DFU_STATUS_OK;
+        break;
+    default:
+        return dfu_err_badreq();
+    }
+    dfu_data.bStatus = status;
+    if (status == USB_DFU_STATUS_OK) {
+        dfu_data.bState = USB_DFU_STATE_DFU_DNLOADSYNC;
+        dfu_data.command = 1;
+    } else {
+        dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+    }
+    return usbd_ack;
+}
+#endif
+
+static usbd_respond dfu_dnload(void *buf, size_t blksize, uint16_t block) {
     switch(dfu_data.bState) {
     case    USB_DFU_STATE_DFU_DNLOADIDLE:
     case    USB_DFU_STATE_DFU_DNLOADSYNC:
     case    USB_DFU_STATE_DFU_IDLE:
         if (blksize == 0) {
-            dfu_data.bState = USB_DFU_STATE_DFU_MANIFESTSYNC;
+            return dfu_manifest();
+        }
+#if (DFU_DUAL_BANK == _ENABLE)
+        /* inactive bank is being changed */
+        dfu_data.swap = 0;
+#endif
+#if (DFU_SKIP_UNCHANGED == _ENABLE)
+        if (dfu_data.bState == USB_DFU_STATE_DFU_IDLE) {
+            dfu_stats.dwPagesSkipped = 0;
+            dfu_stats.dwPagesProgrammed = 0;
+        }
+#endif
+#if (DFU_DFUSE == _ENABLE)
+        if (block == 0) {
+            return dfu_dfuse(buf, blksize);
+        }
+        dfu_data.next += blksize;
+#else
+        (void)block;
+#endif
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+        struct dfu_job_s *job = dfu_free_job();
+        if (job == NULL) {
+            return dfu_err_badreq();
+        }
+        /* block is authenticated before anything is programmed */
+        int datasz = aes_open(dfu_block[job - dfu_job], buf, blksize);
+        buf = dfu_block[job - dfu_job];
+#else
+        /* block is authenticated before anything is programmed */
+        int datasz = aes_open(buf, buf, blksize);
+#endif
+        if (datasz < 0) {
+            dfu_data.bStatus = USB_DFU_STATUS_ERR_VERIFY;
+            dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+            return usbd_ack;
+        }
+#if (DFU_TAGSZ != 0)
+        if (datasz == 0) {
+            /* nonce block of the sealed image, nothing to program */
+            dfu_data.bStatus = USB_DFU_STATUS_OK;
+#if (DFU_DNLOAD_NOSYNC == _ENABLE) && (DFU_DNLOAD_ASYNC != _ENABLE)
+            dfu_data.bState = USB_DFU_STATE_DFU_DNLOADIDLE;
+#else
+            dfu_data.bState = USB_DFU_STATE_DFU_DNLOADSYNC;
+#endif
+            return usbd_ack;
+        }
+#endif
+        blksize = datasz;
+#if (DFU_PATCH == _ENABLE)
+        if (!dfu_data.patch && (dfu_data.interface == 0) && (dfu_data.dptr == (void*)_DFU_START) &&
+            (blksize >= 4) && (*(uint32_t*)buf == PATCH_MAGIC)) {
+            dfu_patch_start();
+#if (DFU_BOOT_RECORD == _ENABLE)
+            dfu_clear_record();
+#endif
+#if (DFU_RESUME == _ENABLE)
+            /* patch stream offsets don't match the image */
+            dfu_journal_drop();
+#endif
+        }
+        if (dfu_data.patch) {
+            /* applied right away, the old data is read from flash */
+            dfu_data.bStatus = patch_update(buf, blksize);
+            if (dfu_data.bStatus != USB_DFU_STATUS_OK) {
+                dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+            } else {
+#if (DFU_DNLOAD_NOSYNC == _ENABLE) && (DFU_DNLOAD_ASYNC != _ENABLE)
+                dfu_data.bState = USB_DFU_STATE_DFU_DNLOADIDLE;
+#else
+                dfu_data.bState = USB_DFU_STATE_DFU_DNLOADSYNC;
+#endif
+            }
             return usbd_ack;
         }
+#endif
         if (blksize > dfu_data.remained) {
             dfu_data.bStatus = USB_DFU_STATUS_ERR_ADDRESS;
             dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
             return usbd_ack;
         }
-        aes_decrypt(buf, buf, blksize );
+#if (DFU_DFUSE == _ENABLE) && (DFU_DNLOAD_ASYNC != _ENABLE)
+        if (dfu_data.moved) {
+            dfu_data.moved = 0;
+            dfu_data.bStatus = dfu_check_moved((size_t)dfu_data.dptr);
+            if (dfu_data.bStatus != USB_DFU_STATUS_OK) {
+                dfu_data.bState = USB_DFU_STATE_DFU_ERROR;
+                return usbd_ack;
+            }
+        }
+#endif
+#if (DFU_BOOT_RECORD == _ENABLE)
+        if ((dfu_data.interface == 0) && (dfu_data.dptr == (void*)_DFU_START)) {
+            dfu_clear_record();
+        }
+#if (DFU_DFUSE == _ENABLE)
+        if ((dfu_data.interface == 0) && dfu_data.targeted) {
+            dfu_clear_record();
+        }
+#endif
+#endif
+#if (DFU_RESUME == _ENABLE)
+        /* stale journal is dropped by any other write to the image */
+        if ((dfu_data.interface == 0) && (dfu_data.dptr == (void*)_DFU_START) && (dfu_data.image == 0)) {
+            dfu_journal_drop();
+        }
+#if (DFU_DFUSE == _ENABLE)
+        if ((dfu_data.interface == 0) && dfu_data.targeted) {
+            dfu_journal_drop();
+        }
+#endif
+#endif
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+        /* programming result is reported by GETSTATUS */
+        job->flash = dfu_data.flash;
+        job->dptr = dfu_data.dptr;
+        job->sptr = buf;
+        job->remained = blksize;
+#if (DFU_DFUSE == _ENABLE)
+        /* checked when the blocks staged before are programmed */
+        job->moved = dfu_data.moved;
+        dfu_data.moved = 0;
+#endif
+        dfu_data.bStatus = USB_DFU_STATUS_OK;
+#else
         dfu_data.bStatus = dfu_data.flash(dfu_data.dptr, buf, blksize);
+#endif
 
         if (dfu_data.bStatus == USB_DFU_STATUS_OK) {
+#if (DFU_VERIFY_CHECKSUM != _DISABLE)
+            if (dfu_data.interface == 0) {
+                checksum_update(buf, blksize);
+            }
+#endif
             dfu_data.dptr += blksize;
             dfu_data.remained -= blksize;
-#if (DFU_DNLOAD_NOSYNC == _ENABLE)
+#if (DFU_RESUME == _ENABLE) && (DFU_DNLOAD_ASYNC != _ENABLE)
+            dfu_journal_update((size_t)dfu_data.dptr - _DFU_START);
+#endif
+#if (DFU_DNLOAD_NOSYNC == _ENABLE) && (DFU_DNLOAD_ASYNC != _ENABLE)
             dfu_data.bState = USB_DFU_STATE_DFU_DNLOADIDLE;
 #else
             dfu_data.bState = USB_DFU_STATE_DFU_DNLOADSYNC;
@@ -164,20 +1202,51 @@ static usbd_respond dfu_dnload(void *buf, size_t blksize) {
 }
 
 static usbd_respond dfu_getstatus(void *buf) {
+    uint32_t timeout = DFU_POLL_TIMEOUT;
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+    if (dfu_data.manifest) {
+        dfu_data.bState = USB_DFU_STATE_DFU_MANIFEST;
+        timeout = dfu_poll_timeout(&dfu_job[dfu_head]);
+    } else if ((dfu_data.bState == USB_DFU_STATE_DFU_DNLOADSYNC) ||
+               (dfu_data.bState == USB_DFU_STATE_DFU_DNBUSY)) {
+        /* busy while both staging buffers are pending or the flush is requested */
+        if ((dfu_free_job() == NULL) || (dfu_data.flush && (dfu_job[dfu_head].remained != 0))) {
+            dfu_data.bState = USB_DFU_STATE_DFU_DNBUSY;
+            timeout = dfu_poll_timeout(&dfu_job[dfu_head]);
+        } else {
+            dfu_data.flush = 0;
+            dfu_data.bState = USB_DFU_STATE_DFU_DNLOADIDLE;
+        }
+    }
+#endif
+#if (DFU_DFUSE == _ENABLE)
+    if (dfu_data.command) {
+        /* DfuSe hosts expect dfuDNBUSY right after the command */
+        dfu_data.command = 0;
+        dfu_data.bState = USB_DFU_STATE_DFU_DNBUSY;
+    }
+#endif
     /* make answer */
     struct usb_dfu_status *stat = buf;
     stat->bStatus = dfu_data.bStatus;
     stat->bState = dfu_data.bState;
-    stat->bPollTimeout = (DFU_POLL_TIMEOUT & 0xFF);
-    stat->wPollTimeout = (DFU_POLL_TIMEOUT >> 8);
+    stat->bPollTimeout = (timeout & 0xFF);
+    stat->wPollTimeout = (timeout >> 8);
     stat->iString = NO_DESCRIPTOR;
 
     switch (dfu_data.bState) {
     case USB_DFU_STATE_DFU_IDLE:
     case USB_DFU_STATE_DFU_DNLOADIDLE:
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+    case USB_DFU_STATE_DFU_DNBUSY:
+    case USB_DFU_STATE_DFU_MANIFEST:
+#endif
     case USB_DFU_STATE_DFU_UPLOADIDLE:
     case USB_DFU_STATE_DFU_ERROR:
         return usbd_ack;
+#if (DFU_DFUSE == _ENABLE) && (DFU_DNLOAD_ASYNC != _ENABLE)
+    case USB_DFU_STATE_DFU_DNBUSY:
+#endif
     case USB_DFU_STATE_DFU_DNLOADSYNC:
         dfu_data.bState = USB_DFU_STATE_DFU_DNLOADIDLE;
         return usbd_ack;
@@ -200,6 +1269,15 @@ static usbd_respond dfu_abort() {
     case USB_DFU_STATE_DFU_DNLOADIDLE:
     case USB_DFU_STATE_DFU_MANIFESTSYNC:
     case USB_DFU_STATE_DFU_UPLOADIDLE:
+#if (DFU_DFUSE == _ENABLE)
+        if (dfu_data.interface == 0) {
+            /* DfuSe hosts set the address and abort to idle before the upload */
+            size_t addr = (size_t)dfu_data.dptr;
+            dfu_set_idle();
+            dfu_set_address(addr);
+            return usbd_ack;
+        }
+#endif
         return dfu_set_idle();
     default:
         return dfu_err_badreq();
@@ -214,15 +1292,313 @@ static usbd_respond dfu_clrstatus() {
     }
 }
 
+#if (DFU_DIGEST == _ENABLE)
+static struct dfu_vendor_digest dfu_digest;
+
+/* hashes the stored image or the units from the address pointer */
+static usbd_respond dfu_get_digest(size_t units) {
+    size_t addr = (size_t)dfu_data.dptr;
+    size_t len = units * DFU_DIGEST_UNIT;
+    if ((dfu_data.interface != 0) ||
+        ((dfu_data.bState != USB_DFU_STATE_DFU_IDLE) && (dfu_data.bState != USB_DFU_STATE_DFU_DNLOADIDLE))) {
+        return usbd_fail;
+    }
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+    /* stalled until the staged blocks are in flash, GETSTATUS reports dfuDNBUSY meanwhile */
+    if (dfu_job[dfu_head].remained != 0) {
+        dfu_data.flush = 1;
+        dfu_data.bState = USB_DFU_STATE_DFU_DNLOADSYNC;
+        return usbd_fail;
+    }
+#endif
+    for (size_t i = 0; i < sizeof(dfu_digest.bDigest); i++) {
+        dfu_digest.bDigest[i] = 0;
+    }
+    if (units == 0) {
+        dfu_digest.dwAddress = _DFU_START;
+        dfu_digest.dwLength = checksum_image(dfu_digest.bDigest, (void*)_DFU_START, _DFU_LENGTH);
+    } else {
+        /* whole units only, short regions would disclose the firmware */
+        if (((addr - _DFU_START) % DFU_DIGEST_UNIT) || (len > _DFU_START + _DFU_LENGTH - addr)) {
+            return usbd_fail;
+        }
+        dfu_digest.dwAddress = addr;
+        dfu_digest.dwLength = len;
+        checksum_region(dfu_digest.bDigest, (void*)addr, len);
+    }
+    return usbd_ack;
+}
+#endif
+
+#if (DFU_RESUME == _ENABLE)
+/* Starts the journaled download or continues the interrupted one. The data
+ * below the offset is already in flash, the cipher and the checksum state
+ * are rebuilt from it.
+ */
+static usbd_respond dfu_resume(const struct dfu_vendor_journal *req) {
+    uint32_t id = req->dwImageId;
+    size_t offset = req->dwOffset;
+    if ((dfu_data.interface != 0) || (dfu_data.bState != USB_DFU_STATE_DFU_IDLE) ||
+        (id == 0) || (id == 0xFFFFFFFF)) {
+        return usbd_fail;
+    }
+    if (offset != 0) {
+        const struct dfu_vendor_journal *jrn = dfu_journal_get();
+        if ((jrn->dwImageId != id) || (jrn->dwOffset != offset)) {
+            return usbd_fail;
+        }
+    }
+    dfu_set_idle();
+    if (offset == 0) {
+        dfu_journal_write(id, 0);
+    } else {
+        const uint8_t *data = (const uint8_t*)_DFU_START;
+        if (aes_seek(offset) != 0) {
+            /* chaining modes end up in the same state after encryption of the plain data */
+            uint32_t tmp[0x10];
+            for (size_t pos = 0; pos < offset; pos += sizeof(tmp)) {
+                size_t sz = (offset - pos < sizeof(tmp)) ? offset - pos : sizeof(tmp);
+                aes_encrypt(tmp, &data[pos], sz);
+            }
+        }
+        checksum_update(data, offset);
+        dfu_data.dptr = (void*)(_DFU_START + offset);
+        dfu_data.remained = _DFU_LENGTH - offset;
+#if (DFU_DFUSE == _ENABLE)
+        dfu_data.next = _DFU_START + offset;
+#endif
+        dfu_data.bState = USB_DFU_STATE_DFU_DNLOADIDLE;
+    }
+    dfu_data.image = id;
+    dfu_data.jrn_offset = offset;
+    return usbd_ack;
+}
+#endif
+
+#if (DFU_TRACE == _ENABLE)
+/* The count and the entries are the DFU_VENDOR_GETTRACE reply. The ring is
+ * reordered oldest first when it's read, head is the next entry to write.
+ */
+static struct {
+    uint32_t                count;
+    struct dfu_vendor_trace entry[DFU_TRACE_DEPTH];
+    uint16_t                head;
+} dfu_trace;
+
+static void dfu_trace_reverse(size_t from, size_t to) {
+    while (from + 1 < to) {
+        struct dfu_vendor_trace tmp = dfu_trace.entry[from];
+        dfu_trace.entry[from++] = dfu_trace.entry[--to];
+        dfu_trace.entry[to] = tmp;
+    }
+}
+
+/** Returns the size of the reply */
+static size_t dfu_trace_read(bool clear) {
+    if (clear) {
+        dfu_trace.count = 0;
+        dfu_trace.head = 0;
+    }
+    if (dfu_trace.count < DFU_TRACE_DEPTH) {
+        return sizeof(dfu_trace.count) + dfu_trace.count * sizeof(struct dfu_vendor_trace);
+    }
+    if (dfu_trace.head != 0) {
+        /* rotation by reversals */
+        dfu_trace_reverse(0, dfu_trace.head);
+        dfu_trace_reverse(dfu_trace.head, DFU_TRACE_DEPTH);
+        dfu_trace_reverse(0, DFU_TRACE_DEPTH);
+        dfu_trace.head = 0;
+    }
+    return sizeof(dfu_trace.count) + sizeof(dfu_trace.entry);
+}
+
+/** Starts the entry for the request to the DFU interface. The data is taken
+ * before the request is processed, the block is decrypted in place.
+ */
+static struct dfu_vendor_trace *dfu_trace_start(const usbd_ctlreq *req) {
+    if (((req->bmRequestType & USB_REQ_RECIPIENT) != USB_REQ_INTERFACE) ||
+        (((req->bmRequestType & USB_REQ_TYPE) == USB_REQ_VENDOR) && (req->bRequest == DFU_VENDOR_GETTRACE))) {
+        return NULL;
+    }
+    struct dfu_vendor_trace *rec = &dfu_trace.entry[dfu_trace.head];
+    rec->bmRequestType = req->bmRequestType;
+    rec->bRequest = req->bRequest;
+    rec->wValue = req->wValue;
+    rec->wLength = req->wLength;
+    for (size_t i = 0; i < sizeof(rec->bData); i++) {
+        rec->bData[i] = ((req->bmRequestType & USB_REQ_DEVTOHOST) || (i >= req->wLength)) ? 0 : req->data[i];
+    }
+    dfu_trace.head = (dfu_trace.head + 1) % DFU_TRACE_DEPTH;
+    dfu_trace.count++;
+    return rec;
+}
+
+static void dfu_trace_end(struct dfu_vendor_trace *rec, usbd_respond res) {
+    if (rec != NULL) {
+        rec->bState = dfu_data.bState;
+        rec->bStatus = dfu_data.bStatus | ((res == usbd_ack) ? 0 : DFU_TRACE_STALL);
+    }
+}
+#endif
+
+#if defined(_VENDOR_ENABLED)
+/** Processing vendor requests to the DFU interface. See dfu_vendor.h */
+static usbd_respond dfu_vendor(usbd_device *dev, usbd_ctlreq *req) {
+    switch (req->bRequest) {
+#if (DFU_SKIP_UNCHANGED == _ENABLE)
+    case DFU_VENDOR_GETSTATS:
+        dev->status.data_ptr = &dfu_stats;
+        dev->status.data_count = sizeof(dfu_stats);
+        break;
+#endif
+#if (DFU_DIGEST == _ENABLE)
+    case DFU_VENDOR_GETDIGEST:
+        if (dfu_get_digest(req->wValue) != usbd_ack) {
+            return usbd_fail;
+        }
+        dev->status.data_ptr = &dfu_digest;
+        dev->status.data_count = sizeof(dfu_digest);
+        break;
+#endif
+#if (DFU_RESUME == _ENABLE)
+    case DFU_VENDOR_GETJOURNAL:
+        dev->status.data_ptr = dfu_journal_get();
+        dev->status.data_count = sizeof(dfu_journal);
+        break;
+    case DFU_VENDOR_RESUME:
+        if ((req->bmRequestType & USB_REQ_DEVTOHOST) || (req->wLength != sizeof(struct dfu_vendor_journal))) {
+            return usbd_fail;
+        }
+        return dfu_resume((const void*)req->data);
+#endif
+#if (DFU_TRACE == _ENABLE)
+    case DFU_VENDOR_GETTRACE:
+        dev->status.data_count = dfu_trace_read(req->wValue == 1);
+        dev->status.data_ptr = &dfu_trace;
+        break;
+#endif
+    default:
+        return usbd_fail;
+    }
+    if (dev->status.data_count > req->wLength) {
+        dev->status.data_count = req->wLength;
+    }
+    return usbd_ack;
+}
+#endif
+
+#if (DFU_BULK == _ENABLE)
+/* sends the oldest pending ack */
+static void dfu_bulk_tx(usbd_device *dev) {
+    if (!dfu_bulk.txbusy && (dfu_bulk.count != 0)) {
+        usbd_ep_write(dev, BULK_EP_IN, &dfu_bulk.ack[dfu_bulk.head], sizeof(struct bulk_ack));
+        dfu_bulk.txbusy = true;
+        dfu_bulk.head = (dfu_bulk.head + 1) % BULK_WINDOW;
+        dfu_bulk.count--;
+    }
+}
+
+/* collected block waits until it can be staged */
+static bool dfu_bulk_ready(void) {
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+    /* zero-length block completes the download after the staged blocks */
+    if (dfu_bulk.rx.hdr.wLength == 0) {
+        return dfu_job[dfu_head].remained == 0;
+    }
+    return dfu_free_job() != NULL;
+#else
+    return true;
+#endif
+}
+
+/* passes the collected block to the DFU_DNLOAD processing and queues the ack */
+static void dfu_bulk_block(void) {
+    const struct bulk_header *hdr = &dfu_bulk.rx.hdr;
+    if (dfu_data.bState != USB_DFU_STATE_DFU_ERROR) {
+        if (hdr->wLength > sizeof(dfu_bulk.block)) {
+            dfu_err_badreq();
+        } else {
+            dfu_dnload(dfu_bulk.block, hdr->wLength, hdr->wBlockNum);
+        }
+    }
+    /* there is no GETSTATUS on the bulk pipe */
+    if (dfu_data.bState == USB_DFU_STATE_DFU_DNLOADSYNC) {
+        dfu_data.bState = USB_DFU_STATE_DFU_DNLOADIDLE;
+#if (DFU_DFUSE == _ENABLE)
+        dfu_data.command = 0;
+#endif
+    }
+    struct bulk_ack *ack = &dfu_bulk.ack[(dfu_bulk.head + dfu_bulk.count) % BULK_WINDOW];
+    ack->wBlockNum = hdr->wBlockNum;
+    ack->bStatus = dfu_data.bStatus;
+    ack->bState = dfu_data.bState;
+    dfu_bulk.count++;
+    if (dfu_data.bState == USB_DFU_STATE_DFU_MANIFESTSYNC) {
+        dfu_set_idle();
+    }
+}
+
+/* passes the packet data to the collector. Returns false if the collected
+ * block waits for the staging buffer, the rest of the packet is kept
+ */
+static bool dfu_bulk_feed(void) {
+    for (;;) {
+        if (bulk_rx_done(&dfu_bulk.rx)) {
+            if (!dfu_bulk_ready()) {
+                return false;
+            }
+            dfu_bulk_block();
+            bulk_rx_init(&dfu_bulk.rx, dfu_bulk.block, sizeof(dfu_bulk.block));
+        }
+        if (dfu_bulk.pktpos == dfu_bulk.pktlen) {
+            return true;
+        }
+        dfu_bulk.pktpos += bulk_rx_feed(&dfu_bulk.rx, (const uint8_t*)dfu_bulk.pkt + dfu_bulk.pktpos,
+                                        dfu_bulk.pktlen - dfu_bulk.pktpos);
+    }
+}
+
+/* Reads the next OUT packet when the previous one is consumed. Until then
+ * the packet waits in the endpoint and the host is NAKed. Called from the
+ * endpoint callback and from the main loop.
+ */
+static void dfu_bulk_rx(usbd_device *dev) {
+    dfu_bulk_tx(dev);
+    /* the host is ahead of the window while the acks are pending */
+    while (dfu_bulk_feed() && dfu_bulk.rxpend && (dfu_bulk.count < BULK_WINDOW)) {
+        int32_t len = usbd_ep_read(dev, BULK_EP_OUT, dfu_bulk.pkt, BULK_EP_SIZE);
+        dfu_bulk.rxpend = false;
+        dfu_bulk.pktpos = 0;
+        dfu_bulk.pktlen = (len > 0) ? len : 0;
+    }
+    dfu_bulk_tx(dev);
+}
+
+static void dfu_bulk_event(usbd_device *dev, uint8_t event, uint8_t ep) {
+    (void)ep;
+    if (event == usbd_evt_eptx) {
+        dfu_bulk.txbusy = false;
+    } else {
+        dfu_bulk.rxpend = true;
+    }
+    dfu_bulk_rx(dev);
+}
+#endif
+
 static void dfu_reset(usbd_device *dev, uint8_t ev, uint8_t ep) {
     (void)dev;
     (void)ev;
     (void)ep;
-    /** TODO : add firmware checkout */
+#if (DFU_DUAL_BANK == _ENABLE)
+    if (dfu_data.swap) {
+        /* returns only if the option bytes are not changed */
+        swap_banks();
+    }
+#endif
     System_Reset();
 }
 
-static usbd_respond dfu_control (usbd_device *dev, usbd_ctlreq *req, usbd_rqc_callback *callback) {
+static usbd_respond dfu_request (usbd_device *dev, usbd_ctlreq *req, usbd_rqc_callback *callback) {
     (void)callback;
     if ((req->bmRequestType  & (USB_REQ_TYPE | USB_REQ_RECIPIENT)) == (USB_REQ_STANDARD | USB_REQ_INTERFACE)) {
         switch (req->bRequest) {
@@ -253,13 +1629,18 @@ static usbd_respond dfu_control (usbd_device *dev, usbd_ctlreq *req, usbd_rqc_ca
             return usbd_ack;
 #endif
         case USB_DFU_DNLOAD:
-            if (req->wLength <= DFU_BLOCKSZ) {
-                return dfu_dnload(req->data, req->wLength);
+            if (req->wLength <= DFU_BLOCKSZ + DFU_TAGSZ) {
+                return dfu_dnload(req->data, req->wLength, req->wValue);
             }
             break;
         case USB_DFU_UPLOAD:
 #if (DFU_CAN_UPLOAD == _ENABLE)
-            if (req->wLength <= DFU_BLOCKSZ) {
+            if (req->wLength <= DFU_BLOCKSZ + DFU_TAGSZ) {
+#if (DFU_DFUSE == _ENABLE)
+                if (req->wValue == 0) {
+                    return dfu_dfuse_commands(dev, req->wLength);
+                }
+#endif
                 return dfu_upload(dev, req->wLength);
             }
 #endif
@@ -277,6 +1658,11 @@ static usbd_respond dfu_control (usbd_device *dev, usbd_ctlreq *req, usbd_rqc_ca
         }
         return dfu_err_badreq();
     }
+#if defined(_VENDOR_ENABLED)
+    if ((req->bmRequestType & (USB_REQ_TYPE | USB_REQ_RECIPIENT)) == (USB_REQ_VENDOR | USB_REQ_INTERFACE)) {
+        return dfu_vendor(dev, req);
+    }
+#endif
 #if (DFU_WCID != _DISABLE)
     if ((req->bmRequestType & USB_REQ_TYPE) == USB_REQ_VENDOR) {
         return dfu_get_vendor_descriptor(req, &dev->status.data_ptr, &dev->status.data_count);
@@ -285,14 +1671,41 @@ static usbd_respond dfu_control (usbd_device *dev, usbd_ctlreq *req, usbd_rqc_ca
     return usbd_fail;
 }
 
+static usbd_respond dfu_control (usbd_device *dev, usbd_ctlreq *req, usbd_rqc_callback *callback) {
+#if (DFU_TRACE == _ENABLE)
+    struct dfu_vendor_trace *rec = dfu_trace_start(req);
+    usbd_respond res = dfu_request(dev, req, callback);
+    dfu_trace_end(rec, res);
+    return res;
+#else
+    return dfu_request(dev, req, callback);
+#endif
+}
+
 
 static usbd_respond dfu_config(usbd_device *dev, uint8_t config) {
     switch (config) {
     case 0:
         usbd_reg_event(dev, usbd_evt_reset, 0);
+#if (DFU_BULK == _ENABLE)
+        usbd_ep_deconfig(dev, BULK_EP_OUT);
+        usbd_ep_deconfig(dev, BULK_EP_IN);
+        usbd_reg_endpoint(dev, BULK_EP_OUT, 0);
+#endif
         break;
     case 1:
         usbd_reg_event(dev, usbd_evt_reset, dfu_reset);
+#if (DFU_BULK == _ENABLE)
+        usbd_ep_config(dev, BULK_EP_OUT, USB_EPTYPE_BULK, BULK_EP_SIZE);
+        usbd_ep_config(dev, BULK_EP_IN, USB_EPTYPE_BULK, BULK_EP_SIZE);
+        /* IN and OUT share the endpoint callback */
+        usbd_reg_endpoint(dev, BULK_EP_OUT, dfu_bulk_event);
+        dfu_bulk.count = 0;
+        dfu_bulk.txbusy = false;
+        dfu_bulk.rxpend = false;
+        dfu_bulk.pktpos = 0;
+        dfu_bulk.pktlen = 0;
+#endif
         break;
     default:
         return usbd_fail;
@@ -302,6 +1715,7 @@ static usbd_respond dfu_config(usbd_device *dev, uint8_t config) {
 
 
 static void dfu_init (void) {
+    aes_init();
     dfu_set_idle();
     usbd_init(&dfu, &usbd_hw, DFU_EP0_SIZE, dfu_buffer, sizeof(dfu_buffer));
     usbd_reg_config(&dfu, dfu_config);
@@ -315,5 +1729,15 @@ int main (void) {
     dfu_init();
     while(1) {
         usbd_poll(&dfu);
+#if (DFU_DNLOAD_ASYNC == _ENABLE)
+        dfu_step();
+        if (dfu_data.manifest && (dfu_job[dfu_head].remained == 0)) {
+            dfu_manifest();
+        }
+#if (DFU_BULK == _ENABLE)
+        /* the held block goes on when the staging buffer is free */
+        dfu_bulk_rx(&dfu);
+#endif
+#endif
     }
 }
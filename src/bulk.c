@@ -0,0 +1,104 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bulk.h"
+
+void bulk_rx_init(struct bulk_rx *rx, void *buf, size_t bufsz) {
+    rx->buf = buf;
+    rx->bufsz = bufsz;
+    rx->pos = 0;
+}
+
+size_t bulk_rx_feed(struct bulk_rx *rx, const void *data, size_t len) {
+    const uint8_t *src = data;
+    size_t cnt = 0;
+    while ((cnt < len) && !bulk_rx_done(rx)) {
+        if (rx->pos < sizeof(struct bulk_header)) {
+            ((uint8_t*)&rx->hdr)[rx->pos] = src[cnt];
+        } else if (rx->pos - sizeof(struct bulk_header) < rx->bufsz) {
+            rx->buf[rx->pos - sizeof(struct bulk_header)] = src[cnt];
+        }
+        rx->pos++;
+        cnt++;
+    }
+    return cnt;
+}
+
+bool bulk_rx_done(const struct bulk_rx *rx) {
+    return (rx->pos >= sizeof(struct bulk_header)) &&
+           (rx->pos == sizeof(struct bulk_header) + rx->hdr.wLength);
+}
+
+/* block is sent with its header in one transfer */
+static int bulk_send_block(const struct bulk_link *link, const uint8_t *data, size_t len, uint16_t num) {
+    uint8_t pkt[sizeof(struct bulk_header) + 0x1000 + 0x40];
+    struct bulk_header *hdr = (struct bulk_header*)pkt;
+    if (len > sizeof(pkt) - sizeof(*hdr)) {
+        return -1;
+    }
+    hdr->wLength = len;
+    hdr->wBlockNum = num;
+    for (size_t i = 0; i < len; i++) {
+        pkt[sizeof(*hdr) + i] = data[i];
+    }
+    return link->send(link->ctx, pkt, sizeof(*hdr) + len);
+}
+
+/* waits for the ack of the oldest block */
+static int bulk_wait_ack(const struct bulk_link *link, uint16_t num) {
+    struct bulk_ack ack;
+    if ((link->recv(link->ctx, &ack) != 0) || (ack.wBlockNum != num)) {
+        return -1;
+    }
+    return ack.bStatus;
+}
+
+int bulk_download(const struct bulk_link *link, const void *data, size_t len, size_t blksize) {
+    const uint8_t *src = data;
+    uint16_t next = BULK_FIRST_BLOCK;
+    uint16_t acked = BULK_FIRST_BLOCK;
+    size_t pos = 0;
+    int res;
+    if (blksize == 0) {
+        return -1;
+    }
+    for (;;) {
+        size_t sz = (len - pos < blksize) ? len - pos : blksize;
+        if ((uint16_t)(next - acked) == BULK_WINDOW) {
+            res = bulk_wait_ack(link, acked++);
+            if (res != 0) {
+                return res;
+            }
+        }
+        /* zero-length block is the last one */
+        if (bulk_send_block(link, &src[pos], sz, next++) != 0) {
+            return -1;
+        }
+        if (sz == 0) {
+            break;
+        }
+        pos += sz;
+    }
+    while (acked != next) {
+        res = bulk_wait_ack(link, acked++);
+        if (res != 0) {
+            return res;
+        }
+    }
+    return 0;
+}
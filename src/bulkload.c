@@ -0,0 +1,207 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Reference host client for the bulk transport (DFU_BULK). Downloads the
+ * fwcrypt output over the bulk endpoints. The control pipe is used to bring
+ * the DFU interface to dfuIDLE and to journal the download if the device
+ * supports DFU_RESUME. Requires libusb-1.0.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libusb-1.0/libusb.h>
+#include "getopt.h"
+#include "config.h"
+#include "bulk.h"
+#include "dfu_vendor.h"
+
+#define DFU_GETSTATUS   0x03
+#define DFU_CLRSTATUS   0x04
+#define DFU_ABORT       0x06
+#define DFU_STATE_ERROR 0x0A
+#define DFU_FUNC_DESC   0x21
+#define TIMEOUT_MS      5000
+
+static void exithelp(void) {
+    printf("Usage: bulkload [options] -i infile\n"
+           "\t infile is the fwcrypt output\n"
+           "\t -d VID:PID device (default %04X:%04X)\n"
+           "\t -r Resume the interrupted download of the same file\n"
+           "\t -h Show this help\n\n", DFU_VENDOR_ID, DFU_DEVICE_ID);
+    exit(1);
+}
+
+static int usb_send(void *ctx, const void *data, size_t len) {
+    int cnt;
+    int res = libusb_bulk_transfer(ctx, BULK_EP_OUT, (uint8_t*)data, len, &cnt, TIMEOUT_MS);
+    return ((res == 0) && ((size_t)cnt == len)) ? 0 : -1;
+}
+
+static int usb_recv(void *ctx, struct bulk_ack *ack) {
+    int cnt;
+    int res = libusb_bulk_transfer(ctx, BULK_EP_IN, (uint8_t*)ack, sizeof(*ack), &cnt, TIMEOUT_MS);
+    return ((res == 0) && (cnt == sizeof(*ack))) ? 0 : -1;
+}
+
+static int dfu_request(libusb_device_handle *h, uint8_t req, uint8_t *data, uint16_t len) {
+    uint8_t type = (len != 0) ? 0xA1 : 0x21;
+    return libusb_control_transfer(h, type, req, 0, 0, data, len, TIMEOUT_MS);
+}
+
+static int dfu_journal(libusb_device_handle *h, uint8_t type, uint8_t req, struct dfu_vendor_journal *jrn) {
+    int res = libusb_control_transfer(h, type, req, 0, 0, (uint8_t*)jrn, sizeof(*jrn), TIMEOUT_MS);
+    return (res == sizeof(*jrn)) ? 0 : -1;
+}
+
+/* FNV-1a of the stream identifies the image in the journal */
+static uint32_t image_id(const uint8_t *data, size_t len) {
+    uint32_t hash = 0x811C9DC5;
+    while (len--) {
+        hash = (hash ^ *data++) * 0x01000193;
+    }
+    return ((hash == 0) || (hash == 0xFFFFFFFF)) ? 1 : hash;
+}
+
+/* wTransferSize from the DFU functional descriptor */
+static size_t get_transfer_size(libusb_device_handle *h) {
+    struct libusb_config_descriptor *cfg;
+    size_t size = 0;
+    if (libusb_get_active_config_descriptor(libusb_get_device(h), &cfg) != 0) {
+        return 0;
+    }
+    /* it follows the last alternate setting */
+    for (int alt = 0; alt < cfg->interface[0].num_altsetting; alt++) {
+        const struct libusb_interface_descriptor *intf = &cfg->interface[0].altsetting[alt];
+        for (int pos = 0; pos + 7 <= intf->extra_length; pos += intf->extra[pos]) {
+            if (intf->extra[pos] == 0) {
+                break;
+            }
+            if (intf->extra[pos + 1] == DFU_FUNC_DESC) {
+                size = intf->extra[pos + 5] | intf->extra[pos + 6] << 8;
+            }
+        }
+    }
+    libusb_free_config_descriptor(cfg);
+    return size;
+}
+
+int main(int argc, char **argv) {
+    char *infile = NULL;
+    unsigned vid = DFU_VENDOR_ID;
+    unsigned pid = DFU_DEVICE_ID;
+    int resume = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "hi:d:r")) != -1) {
+        switch (opt) {
+        case 'i':
+            infile = optarg;
+            break;
+        case 'r':
+            resume = 1;
+            break;
+        case 'd':
+            if (sscanf(optarg, "%x:%x", &vid, &pid) != 2) {
+                exithelp();
+            }
+            break;
+        default:
+            exithelp();
+        }
+    }
+    if (infile == NULL) {
+        exithelp();
+    }
+
+    FILE *fi = fopen(infile, "rb");
+    if (fi == NULL) {
+        printf("Failed to open input file.\n");
+        exit(2);
+    }
+    fseek(fi, 0, SEEK_END);
+    size_t length = ftell(fi);
+    fseek(fi, 0, SEEK_SET);
+    uint8_t *buf = malloc(length + 1);
+    if ((buf == NULL) || (fread(buf, 1, length, fi) != length)) {
+        printf("Failed to read input file.\n");
+        exit(3);
+    }
+    fclose(fi);
+    /* DFU suffix is not sent */
+    if ((length >= 16) && (memcmp(&buf[length - 8], "UFD", 3) == 0)) {
+        length -= buf[length - 5];
+    }
+
+    libusb_device_handle *h = NULL;
+    if ((libusb_init(NULL) != 0) ||
+        ((h = libusb_open_device_with_vid_pid(NULL, vid, pid)) == NULL)) {
+        printf("Device %04X:%04X not found.\n", vid, pid);
+        exit(4);
+    }
+    size_t blksize = get_transfer_size(h);
+    if ((blksize == 0) ||
+        (libusb_claim_interface(h, 0) != 0) || (libusb_claim_interface(h, 1) != 0)) {
+        printf("No DFU bulk interface found.\n");
+        exit(5);
+    }
+
+    uint8_t stat[6];
+    if ((dfu_request(h, DFU_GETSTATUS, stat, sizeof(stat)) == sizeof(stat)) && (stat[4] == DFU_STATE_ERROR)) {
+        dfu_request(h, DFU_CLRSTATUS, NULL, 0);
+    }
+    dfu_request(h, DFU_ABORT, NULL, 0);
+
+    /* journal is ignored by the devices without DFU_RESUME */
+    struct dfu_vendor_journal jrn = {0, 0};
+    uint32_t id = image_id(buf, length);
+    size_t start = 0;
+    if (resume && (dfu_journal(h, 0xC1, DFU_VENDOR_GETJOURNAL, &jrn) == 0) &&
+        (jrn.dwImageId == id) && (jrn.dwOffset != 0)) {
+        start = (jrn.dwOffset / DFU_BLOCKSZ) * blksize;
+    }
+    if ((start != 0) && ((start > length) || (dfu_journal(h, 0x41, DFU_VENDOR_RESUME, &jrn) != 0))) {
+        start = 0;
+    }
+    if (start == 0) {
+        jrn.dwImageId = id;
+        jrn.dwOffset = 0;
+        dfu_journal(h, 0x41, DFU_VENDOR_RESUME, &jrn);
+    } else {
+        printf("Resuming at %zd.\n", start);
+#if (DFU_TAGSZ != 0)
+        /* sealed image is opened by its nonce block again, it goes before the next block */
+        memcpy(&buf[start], buf, blksize);
+#endif
+    }
+
+    printf("Downloading %zd bytes in %zd byte blocks.\n", length - start, blksize);
+    struct bulk_link link = {h, usb_send, usb_recv};
+    int res = bulk_download(&link, buf + start, length - start, blksize);
+    if (res < 0) {
+        printf("Transfer failed.\n");
+    } else if (res != 0) {
+        printf("Device status %d.\n", res);
+    } else {
+        printf("OK.\n");
+    }
+
+    libusb_release_interface(h, 1);
+    libusb_release_interface(h, 0);
+    libusb_close(h);
+    libusb_exit(NULL);
+    free(buf);
+    return (res == 0) ? 0 : 6;
+}
@@ -22,10 +22,14 @@
 #include "misc.h"
 #include "chacha.h"
 
-#define QR(s,a,b,c,d) Qround((s), (a) << 24 | (b) << 16 | (c) << 8 | (d) << 0)
-
 #define SPLIT(x) (x) & 0xFF, ((x) >> 8) & 0xFF, ((x) >> 16) & 0xFF, ((x) >> 24) & 0xFF
 
+#define QR(a, b, c, d)                  \
+    a += b; d ^= a; d = __rol32(d, 16); \
+    c += d; b ^= c; b = __rol32(b, 12); \
+    a += b; d ^= a; d = __rol32(d, 8);  \
+    c += d; b ^= c; b = __rol32(b, 7);
+
 static const uint8_t prefix[] = {
     0x65, 0x78, 0x70, 0x61, 0x6e, 0x64, 0x20, 0x33,
     0x32, 0x2d, 0x62, 0x79, 0x74, 0x65, 0x20, 0x6b,
@@ -35,39 +39,39 @@ static uint32_t inits[16];
 static uint32_t state[16];
 static uint8_t  bytecount;
 
-static void Qround (uint32_t *s, uint32_t abcd) {
-
-    uint32_t A = s[(abcd >> 24) & 0x0F];
-    uint32_t B = s[(abcd >> 16) & 0x0F];
-    uint32_t C = s[(abcd >> 8 ) & 0x0F];
-    uint32_t D = s[(abcd >> 0 ) & 0x0F];
-
-    A += B; D ^= A; D = __rol32(D, 16);
-    C += D; B ^= C; B = __rol32(B, 12);
-    A += B; D ^= A; D = __rol32(D, 8);
-    C += D; B ^= C; B = __rol32(B, 7);
-
-    s[(abcd >> 24) & 0x0F] = A;
-    s[(abcd >> 16) & 0x0F] = B;
-    s[(abcd >> 8)  & 0x0F] = C;
-    s[(abcd >> 0)  & 0x0F] = D;
-}
-
-static void chacha_block() {
-    memcpy(state, inits, sizeof(state));
+/* Generates 64-byte keystream block for the current counter.
+ * Whole state kept in the local variables, rounds are unrolled. */
+static void chacha_block(uint32_t *out) {
+    uint32_t x0  = inits[0],  x1  = inits[1],  x2  = inits[2],  x3  = inits[3];
+    uint32_t x4  = inits[4],  x5  = inits[5],  x6  = inits[6],  x7  = inits[7];
+    uint32_t x8  = inits[8],  x9  = inits[9],  x10 = inits[10], x11 = inits[11];
+    uint32_t x12 = inits[12], x13 = inits[13], x14 = inits[14], x15 = inits[15];
     for (int i = 0; i < 10; i++) {
-        QR(state, 0, 4,  8, 12);
-        QR(state, 1, 5,  9, 13);
-        QR(state, 2, 6, 10, 14);
-        QR(state, 3, 7, 11, 15);
-        QR(state, 0, 5, 10, 15);
-        QR(state, 1, 6, 11, 12);
-        QR(state, 2, 7,  8, 13);
-        QR(state, 3, 4,  9, 14);
-    }
-    for (int i = 0; i < 16; i++) {
-        state[i] += inits[i];
+        QR(x0, x4,  x8, x12);
+        QR(x1, x5,  x9, x13);
+        QR(x2, x6, x10, x14);
+        QR(x3, x7, x11, x15);
+        QR(x0, x5, x10, x15);
+        QR(x1, x6, x11, x12);
+        QR(x2, x7,  x8, x13);
+        QR(x3, x4,  x9, x14);
     }
+    out[0]  = x0  + inits[0];
+    out[1]  = x1  + inits[1];
+    out[2]  = x2  + inits[2];
+    out[3]  = x3  + inits[3];
+    out[4]  = x4  + inits[4];
+    out[5]  = x5  + inits[5];
+    out[6]  = x6  + inits[6];
+    out[7]  = x7  + inits[7];
+    out[8]  = x8  + inits[8];
+    out[9]  = x9  + inits[9];
+    out[10] = x10 + inits[10];
+    out[11] = x11 + inits[11];
+    out[12] = x12 + inits[12];
+    out[13] = x13 + inits[13];
+    out[14] = x14 + inits[14];
+    out[15] = x15 + inits[15];
 }
 
 void chacha_init(const void* key, const void* nonce) {
@@ -81,8 +85,58 @@ void chacha_init(const void* key, const void* nonce) {
 void chacha_crypt(void *out, const void *in) {
     if ((bytecount & 0x3F) == 0) {
         inits[12]++;
-        chacha_block();
+        chacha_block(state);
     }
     *(uint8_t*)out = *(uint8_t*)in ^ ((uint8_t*)state)[bytecount & 0x3F];
     bytecount++;
 }
+
+void chacha_seek(uint32_t offset) {
+    inits[12] = offset >> 6;
+    bytecount = offset & 0x3F;
+    if (bytecount) {
+        inits[12]++;
+        chacha_block(state);
+    }
+}
+
+void chacha_poly_key(void *out) {
+    uint32_t block[16];
+    uint32_t counter = inits[12];
+    inits[12] = 0;
+    chacha_block(block);
+    inits[12] = counter;
+    memcpy(out, block, 32);
+}
+
+void chacha_keystream(void *out) {
+    inits[12]++;
+    chacha_block(out);
+}
+
+void chacha_xor(void *out, const void *in, size_t sz) {
+    uint8_t *o = out;
+    const uint8_t *i = in;
+    /* finish the current keystream block */
+    while (sz && (bytecount & 0x3F)) {
+        chacha_crypt(o++, i++);
+        sz--;
+    }
+    /* whole blocks */
+    if ((((uintptr_t)o | (uintptr_t)i) & 0x03) == 0) {
+        while (sz >= 64) {
+            inits[12]++;
+            chacha_block(state);
+            for (int j = 0; j < 16; j++) {
+                ((uint32_t*)o)[j] = ((const uint32_t*)i)[j] ^ state[j];
+            }
+            o += 64;
+            i += 64;
+            sz -= 64;
+        }
+    }
+    /* tail and unaligned data */
+    while (sz--) {
+        chacha_crypt(o++, i++);
+    }
+}
@@ -22,35 +22,50 @@
 #include <string.h>
 #include "config.h"
 #include "checksum.h"
+#include "crctable.h"
 
 
-#if ((DFU_VERIFY_CHECKSUM == CRC32FAST) || (DFU_VERIFY_CHECKSUM == CRC32SMALL))
+/* CHECKSUM_ID identifies the algorithm in the image header. It's the same
+ * for all implementations of the algorithm.
+ */
+#if ((DFU_VERIFY_CHECKSUM == CRC32FAST) || (DFU_VERIFY_CHECKSUM == CRC32SMALL) || \
+     (DFU_VERIFY_CHECKSUM == CRC32SLICE4) || (DFU_VERIFY_CHECKSUM == CRC32NIBBLE))
     typedef uint32_t checksum_t;
     const char *checksum_name = "CRC-32";
+    #define CHECKSUM_ID CRC32FAST
     #define CRC_POLY 0xEDB88320UL
     #define CRC_INIT 0xFFFFFFFFUL
+    #define CRC_TABLE(n) CRC32_TABLE##n
+    #define CRC_NIBBLE CRC32_NIBBLE
 
-#elif ((DFU_VERIFY_CHECKSUM == CRC64FAST) || (DFU_VERIFY_CHECKSUM == CRC64SMALL))
+#elif ((DFU_VERIFY_CHECKSUM == CRC64FAST) || (DFU_VERIFY_CHECKSUM == CRC64SMALL) || \
+       (DFU_VERIFY_CHECKSUM == CRC64SLICE4) || (DFU_VERIFY_CHECKSUM == CRC64NIBBLE))
     typedef uint64_t checksum_t;
     const char *checksum_name = "CRC-64";
+    #define CHECKSUM_ID CRC64FAST
     #define CRC_POLY 0x95AC9329AC4BC9B5ULL
     #define CRC_INIT 0xFFFFFFFFFFFFFFFFULL
+    #define CRC_TABLE(n) CRC64_TABLE##n
+    #define CRC_NIBBLE CRC64_NIBBLE
 
 #elif (DFU_VERIFY_CHECKSUM == FNV1A32)
     typedef uint32_t checksum_t;
     const char *checksum_name = "FNV1A-32";
+    #define CHECKSUM_ID FNV1A32
     #define FNV_OFFS 0x811c9dc5UL
     #define FNV_PRIM 16777619UL
 
 #elif (DFU_VERIFY_CHECKSUM == FNV1A64)
     const char *checksum_name = "FNV1A-64";
     typedef uint64_t checksum_t;
+    #define CHECKSUM_ID FNV1A64
     #define FNV_OFFS 0xcbf29ce484222325ULL
     #define FNV_PRIM 1099511628211ULL
 
 #else
     const char *checksum_name = "NONE";
     typedef uint32_t checksum_t;
+    #define CHECKSUM_ID 0
 #endif
 
 /* Function prototypes */
@@ -61,20 +76,9 @@ inline static void update_checksum(checksum_t *checksum, uint8_t data);
 /* Function implementations */
 #if ((DFU_VERIFY_CHECKSUM == CRC32FAST) || (DFU_VERIFY_CHECKSUM == CRC64FAST))
 
-static checksum_t table[0x100];
+static const checksum_t table[0x100] = { CRC_TABLE(0) };
 
 static void init_checksum(checksum_t *checksum) {
-    for (int j = 0; j < 256; j++) {
-        uint64_t cs = j;
-        for (int i = 0; i < 8; i++) {
-            if (cs & 0x01) {
-                cs = (cs >> 1) ^ CRC_POLY;
-            } else {
-                cs = (cs >> 1);
-            }
-        }
-        table[j] = cs;
-    }
     *checksum = CRC_INIT;
 }
 
@@ -83,6 +87,45 @@ static void update_checksum(checksum_t *checksum, uint8_t data) {
     *checksum = (*checksum >> 8) ^ table[data];
 }
 
+#elif ((DFU_VERIFY_CHECKSUM == CRC32SLICE4) || (DFU_VERIFY_CHECKSUM == CRC64SLICE4))
+/* slice-by-4. table[0] is the byte-wise table, table[n] advances it by n bytes */
+#define CRC_SLICE4
+
+static const checksum_t table[4][0x100] = {
+    { CRC_TABLE(0) }, { CRC_TABLE(1) }, { CRC_TABLE(2) }, { CRC_TABLE(3) },
+};
+
+static void init_checksum(checksum_t *checksum) {
+    *checksum = CRC_INIT;
+}
+
+static void update_checksum(checksum_t *checksum, uint8_t data) {
+    data ^= *checksum & 0xFF;
+    *checksum = (*checksum >> 8) ^ table[0][data];
+}
+
+/* processes one little-endian 32-bit word */
+static void update_checksum32(checksum_t *checksum, uint32_t data) {
+    checksum_t cs = *checksum ^ data;
+    *checksum = (cs >> 16 >> 16) ^
+                table[3][cs & 0xFF] ^ table[2][(cs >> 8) & 0xFF] ^
+                table[1][(cs >> 16) & 0xFF] ^ table[0][(cs >> 24) & 0xFF];
+}
+
+#elif ((DFU_VERIFY_CHECKSUM == CRC32NIBBLE) || (DFU_VERIFY_CHECKSUM == CRC64NIBBLE))
+/* 16-entry table, two lookups per byte. table[i] is the CRC of the nibble i */
+static const checksum_t table[0x10] = { CRC_NIBBLE };
+
+static void init_checksum(checksum_t *checksum) {
+    *checksum = CRC_INIT;
+}
+
+static void update_checksum(checksum_t *checksum, uint8_t data) {
+    checksum_t cs = *checksum ^ data;
+    cs = (cs >> 4) ^ table[cs & 0x0F];
+    *checksum = (cs >> 4) ^ table[cs & 0x0F];
+}
+
 #elif ((DFU_VERIFY_CHECKSUM == CRC32SMALL) || (DFU_VERIFY_CHECKSUM == CRC64SMALL))
 
 static void init_checksum(checksum_t *checksum) {
@@ -127,33 +170,168 @@ static int __memcmp(const void *a, const void *b, size_t len) {
     return 0;
 }
 
+/* Image header lives in the reserved entries of the application vector
+ * table. It holds the image length and the algorithm. Checksum is appended
+ * right after the image, so it can be found without scanning.
+ * Entries 0x20..0x27 are kept erased for the bootloader's boot record and
+ * always hashed as 0xFF.
+ */
+#define HDR_LENGTH      (0x1C / 4)
+#define HDR_RECORD      (0x20 / 4)
+#define HDR_MAGIC       (0x28 / 4)
+#define HDR_SIZE        0x2C
+#define CHECKSUM_MAGIC  (0x53430000UL | CHECKSUM_ID)
+
 const size_t checksum_length = sizeof(checksum_t);
 
+#if defined(CRC_SLICE4)
+static void update_range(checksum_t *cs, const uint8_t *buf, size_t len) {
+    while (len && ((uintptr_t)buf & 0x03)) {
+        update_checksum(cs, *buf++);
+        len--;
+    }
+    for (; len >= 4; len -= 4) {
+        update_checksum32(cs, *(const uint32_t*)buf);
+        buf += 4;
+    }
+    while (len--) {
+        update_checksum(cs, *buf++);
+    }
+}
+#else
+static void update_range(checksum_t *cs, const uint8_t *buf, size_t len) {
+    while (len--) {
+        update_checksum(cs, *buf++);
+    }
+}
+#endif
+
+/* header is hashed with the boot record area as erased */
+static void update_header(checksum_t *cs, const uint8_t *hdr) {
+    static const uint8_t erased[8] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    update_range(cs, hdr, 4 * HDR_RECORD);
+    update_range(cs, erased, sizeof(erased));
+    update_range(cs, hdr + 4 * HDR_MAGIC, HDR_SIZE - 4 * HDR_MAGIC);
+}
+
+static void compute_checksum(checksum_t *cs, const uint8_t *buf, size_t len) {
+    init_checksum(cs);
+    update_header(cs, buf);
+    update_range(cs, buf + HDR_SIZE, len - HDR_SIZE);
+}
+
 size_t append_checksum(void *data, size_t len, size_t bsize) {
     checksum_t cs;
-    uint8_t *buf = data;
-    if (bsize < len + sizeof(checksum_t)) {
+    uint32_t *hdr = data;
+    if ((len < HDR_SIZE) || (bsize < len + sizeof(checksum_t))) {
         return 0;
     }
-    init_checksum(&cs);
-    for (size_t i = 0; i < len; i++) {
-        update_checksum(&cs, *buf);
-        buf++;
+    for (int i = HDR_LENGTH; i <= HDR_MAGIC; i++) {
+        if (hdr[i] != 0) return 0;
     }
-    memcpy(buf, &cs, sizeof(cs));
+    hdr[HDR_LENGTH] = len;
+    hdr[HDR_RECORD] = 0xFFFFFFFF;
+    hdr[HDR_RECORD + 1] = 0xFFFFFFFF;
+    hdr[HDR_MAGIC] = CHECKSUM_MAGIC;
+    compute_checksum(&cs, data, len);
+    memcpy((uint8_t*)data + len, &cs, sizeof(cs));
     return len + sizeof(checksum_t);
 }
 
+size_t checksum_image_length(const void *data, size_t bsize) {
+    const uint32_t *hdr = data;
+    size_t len;
+    if (bsize < HDR_SIZE + sizeof(checksum_t)) {
+        return 0;
+    }
+    if (hdr[HDR_MAGIC] != CHECKSUM_MAGIC) {
+        return 0;
+    }
+    len = hdr[HDR_LENGTH];
+    if ((len < HDR_SIZE) || (len > bsize - sizeof(checksum_t))) {
+        return 0;
+    }
+    return len;
+}
+
 size_t validate_checksum(const void *data, size_t bsize)  {
     checksum_t cs;
-    const uint8_t *buf = data;
+    size_t len = checksum_image_length(data, bsize);
+    if (len == 0) {
+        return 0;
+    }
+    compute_checksum(&cs, data, len);
+    if (__memcmp(&cs, (const uint8_t*)data + len, sizeof(cs)) != 0) {
+        return 0;
+    }
+    return len;
+}
+
+size_t checksum_image(void *digest, const void *data, size_t bsize) {
+    checksum_t cs;
+    size_t len = checksum_image_length(data, bsize);
+    if (len == 0) {
+        return 0;
+    }
+    compute_checksum(&cs, data, len);
+    memcpy(digest, &cs, sizeof(cs));
+    return len;
+}
+
+void checksum_region(void *digest, const void *data, size_t len) {
+    checksum_t cs;
     init_checksum(&cs);
-    while(sizeof(checksum_t) <= bsize--) {
-        if (__memcmp(&cs, buf, sizeof(cs)) == 0) {
-            return (size_t)(buf - (uint8_t *)data);
+    update_range(&cs, data, len);
+    memcpy(digest, &cs, sizeof(cs));
+}
+
+/* Streaming verification. Data is split by the image header, image body,
+ * stored checksum and the tail that is ignored.
+ */
+static struct {
+    checksum_t  cs;
+    checksum_t  stored;
+    size_t      pos;
+    size_t      len;
+    uint32_t    hdr[HDR_SIZE / 4];
+} stream;
+
+void checksum_init(void) {
+    init_checksum(&stream.cs);
+    stream.pos = 0;
+    stream.len = 0;
+}
+
+void checksum_update(const void *data, size_t sz) {
+    const uint8_t *buf = data;
+    while (sz) {
+        size_t n = sz;
+        if (stream.pos < HDR_SIZE) {
+            if (n > HDR_SIZE - stream.pos) n = HDR_SIZE - stream.pos;
+            memcpy((uint8_t*)stream.hdr + stream.pos, buf, n);
+            if (stream.pos + n == HDR_SIZE) {
+                stream.len = checksum_image_length(stream.hdr, (size_t)-1);
+                update_header(&stream.cs, (uint8_t*)stream.hdr);
+            }
+        } else if (stream.pos < stream.len) {
+            if (n > stream.len - stream.pos) n = stream.len - stream.pos;
+            update_range(&stream.cs, buf, n);
+        } else if (stream.pos < stream.len + sizeof(checksum_t)) {
+            if (n > stream.len + sizeof(checksum_t) - stream.pos) n = stream.len + sizeof(checksum_t) - stream.pos;
+            memcpy((uint8_t*)&stream.stored + (stream.pos - stream.len), buf, n);
         }
-        update_checksum(&cs, *buf);
-        buf++;
+        stream.pos += n;
+        buf += n;
+        sz -= n;
     }
-    return 0;
+}
+
+size_t checksum_final(void) {
+    if ((stream.len == 0) || (stream.pos < stream.len + sizeof(checksum_t))) {
+        return 0;
+    }
+    if (__memcmp(&stream.cs, &stream.stored, sizeof(checksum_t)) != 0) {
+        return 0;
+    }
+    return stream.len;
 }
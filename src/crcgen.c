@@ -0,0 +1,90 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Host tool. Writes the reflected CRC-32 and CRC-64 lookup tables as a header,
+ * so the firmware and fwcrypt get them as const data instead of building
+ * them at runtime.
+ * CRCxx_TABLEn is the slice-by-4 table n (TABLE0 is the byte-wise table),
+ * CRCxx_NIBBLE is the 16-entry table for the nibble-wise variants.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define CRC32_POLY 0xEDB88320UL
+#define CRC64_POLY 0x95AC9329AC4BC9B5ULL
+
+static uint64_t table[4][0x100];
+
+static void build(uint64_t poly) {
+    for (int j = 0; j < 0x100; j++) {
+        uint64_t cs = j;
+        for (int i = 0; i < 8; i++) {
+            cs = (cs & 0x01) ? (cs >> 1) ^ poly : (cs >> 1);
+        }
+        table[0][j] = cs;
+    }
+    for (int i = 1; i < 4; i++) {
+        for (int j = 0; j < 0x100; j++) {
+            table[i][j] = ((table[i - 1][j] >> 8) ^ table[0][table[i - 1][j] & 0xFF]);
+        }
+    }
+}
+
+static void dump(FILE *f, const char *name, int wide, const uint64_t *data, size_t step, size_t cnt) {
+    int cols = wide ? 4 : 6;
+    fprintf(f, "#define %s", name);
+    for (size_t i = 0; i < cnt; i++) {
+        fprintf(f, "%s", (i == 0) ? " \\\n    " : (i % cols) ? ", " : ", \\\n    ");
+        if (wide) {
+            fprintf(f, "0x%016llXULL", (unsigned long long)data[i * step]);
+        } else {
+            fprintf(f, "0x%08lXUL", (unsigned long)data[i * step]);
+        }
+    }
+    fprintf(f, "\n\n");
+}
+
+static void dump_tables(FILE *f, const char *prefix, int wide) {
+    char name[32];
+    for (int i = 0; i < 4; i++) {
+        snprintf(name, sizeof(name), "%s_TABLE%d", prefix, i);
+        dump(f, name, wide, table[i], 1, 0x100);
+    }
+    /* nibble table entry n is the byte table entry n << 4 */
+    snprintf(name, sizeof(name), "%s_NIBBLE", prefix);
+    dump(f, name, wide, table[0], 0x10, 0x10);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        printf("Usage: crcgen <output header>\n");
+        return 1;
+    }
+    FILE *f = fopen(argv[1], "w");
+    if (f == NULL) {
+        printf("Failed to open output file %s\n", argv[1]);
+        return 2;
+    }
+    fprintf(f, "/* This file is automatically generated. CRC-32 and CRC-64 lookup tables */\n");
+    fprintf(f, "#ifndef _CRCTABLE_H_\n#define _CRCTABLE_H_\n\n");
+    build(CRC32_POLY);
+    dump_tables(f, "CRC32", 0);
+    build(CRC64_POLY);
+    dump_tables(f, "CRC64", 1);
+    fprintf(f, "#endif\n");
+    fclose(f);
+    return 0;
+}
@@ -5,7 +5,11 @@
 static const uint8_t key[] __attribute__((unused));
 static const uint8_t nonce[] __attribute__((unused));
 static uint32_t IV[] __attribute__((unused));
-static void* memxor(void *dst, const void *src, size_t sz) __attribute__((unused));
+
+#if (DFU_CIPHER_MODE == DFU_CIPHER_AEAD) && (DFU_CIPHER != DFU_CIPHER_CHACHA) && \
+    ((DFU_CIPHER != DFU_CIPHER_CHACHA_A) || defined(__thumb__))
+    #error "Authenticated mode requires CHACHA cipher (C version)"
+#endif
 
 #if (DFU_CIPHER == DFU_CIPHER_RC5_A) && defined(__thumb__)
     #include "rc5_a.h"
@@ -105,6 +109,7 @@ static void* memxor(void *dst, const void *src, size_t sz) __attribute__((unused
     #define CRYPTO_NONCE
     #define CRYPTO_KEY DFU_AES_KEY_128
     #define crypto_init(key, nonce) arc4_init(key)
+    #define crypto_reset(key, nonce) arc4_init(key)
     #define crypto_encrypt(out, in) arc4_crypt(out, in)
     #define crypto_decrypt(out, in) arc4_crypt(out, in)
 
@@ -119,6 +124,7 @@ static void* memxor(void *dst, const void *src, size_t sz) __attribute__((unused
     #define CRYPTO_KEY DFU_AES_KEY_256
     #define CRYPTO_NONCE DFU_AES_IV_96
     #define crypto_init(key, nonce) _chacha_init(key, nonce)
+    #define crypto_reset(key, nonce) _chacha_init(key, nonce)
     #define crypto_encrypt(out, in) _chacha_crypt(out, in)
     #define crypto_decrypt(out, in) _chacha_crypt(out, in)
 
@@ -128,13 +134,19 @@ static void* memxor(void *dst, const void *src, size_t sz) __attribute__((unused
     #define CRYPTO_KEYSIZE 32
     #define CRYPTO_IVSIZE  12
     #define CRYPTO_NAME    "RFC7539-CHACHA20"
+    #if (DFU_CIPHER_MODE != DFU_CIPHER_AEAD)
     #undef  DFU_CIPHER_MODE
     #define DFU_CIPHER_MODE -1
+    #endif
     #define CRYPTO_KEY DFU_AES_KEY_256
     #define CRYPTO_NONCE DFU_AES_IV_96
     #define crypto_init(key, nonce) chacha_init(key, nonce)
+    #define crypto_reset(key, nonce) chacha_init(key, nonce)
     #define crypto_encrypt(out, in) chacha_crypt(out, in)
     #define crypto_decrypt(out, in) chacha_crypt(out, in)
+    #define crypto_stream(out, in, sz) chacha_xor(out, in, sz)
+    #define crypto_seek(offset) chacha_seek(offset)
+    #define crypto_polykey(out) chacha_poly_key(out)
 
 #elif (DFU_CIPHER == DFU_CIPHER_BLOWFISH)
     #include "blowfish.h"
@@ -219,131 +231,249 @@ static void* memxor(void *dst, const void *src, size_t sz) __attribute__((unused
     }
 
     #define crypto_decrypt(out, in) crypto_encrypt(out, in);
+    #define crypto_seek(...)
 
 #endif
 
 /* blocksize in 32-bit chunks */
 #define CRYPTO_BLKSIZE32 ((CRYPTO_BLKSIZE + 3) >> 2)
 
+/* Block modes works with the whole DFU block at once. Data is processed in
+ * 32-bit words, so input and output buffers must be 32-bit aligned.
+ * In-place operation (out == in) is allowed.
+ */
+static inline void copy_block(uint32_t *out, const uint32_t *in) {
+    for (int i = 0; i < CRYPTO_BLKSIZE32; i++) {
+        out[i] = in[i];
+    }
+}
+
+static inline void xor_block(uint32_t *out, const uint32_t *a, const uint32_t *b) {
+    for (int i = 0; i < CRYPTO_BLKSIZE32; i++) {
+        out[i] = a[i] ^ b[i];
+    }
+}
+
 #if !defined(DFU_CIPHER_MODE) || (DFU_CIPHER_MODE == DFU_CIPHER_CBC)
 #define CRYPTO_MODE "-CBC"
 #define crypto_init_iv(dst, src, size) memcpy((dst), (src), (size))
-static void encrypt_block(void *out, const void *in) {
-    uint32_t TB[CRYPTO_BLKSIZE32];
-    memcpy(TB, in, CRYPTO_BLKSIZE);
-    memxor(TB, IV, CRYPTO_BLKSIZE);
-    crypto_encrypt(IV, TB);
-    memcpy(out, IV, CRYPTO_BLKSIZE);
+static void encrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
+    while (count--) {
+        xor_block(IV, IV, in);
+        crypto_encrypt(IV, IV);
+        copy_block(out, IV);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
 }
 
-static void decrypt_block(void *out, const void *in) {
+static void decrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
     uint32_t TB[CRYPTO_BLKSIZE32];
-    memcpy(TB, in, CRYPTO_BLKSIZE);
-    crypto_decrypt(TB, TB);
-    memxor(TB, IV, CRYPTO_BLKSIZE);
-    memcpy(IV, in, CRYPTO_BLKSIZE);
-    memcpy(out, TB, CRYPTO_BLKSIZE);
+    while (count--) {
+        crypto_decrypt(TB, in);
+        xor_block(TB, TB, IV);
+        copy_block(IV, in);
+        copy_block(out, TB);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
 }
 
 #elif (DFU_CIPHER_MODE == DFU_CIPHER_PCBC)
 #define CRYPTO_MODE "-PCBC"
 #define crypto_init_iv(dst, src, size) memcpy((dst), (src), (size))
-static void encrypt_block(void *out, const void *in) {
+static void encrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
     uint32_t TB[CRYPTO_BLKSIZE32];
-    memcpy(TB, in, CRYPTO_BLKSIZE);
-    memxor(IV, TB, CRYPTO_BLKSIZE);
-    crypto_encrypt(IV, IV);
-    memcpy(out, IV, CRYPTO_BLKSIZE);
-    memxor(IV, TB, CRYPTO_BLKSIZE);
+    while (count--) {
+        copy_block(TB, in);
+        xor_block(IV, IV, TB);
+        crypto_encrypt(IV, IV);
+        copy_block(out, IV);
+        xor_block(IV, IV, TB);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
 }
 
-static void decrypt_block(void *out, const void *in) {
+static void decrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
     uint32_t TB[CRYPTO_BLKSIZE32];
-    memcpy(TB, in, CRYPTO_BLKSIZE);
-    crypto_decrypt(TB, TB);
-    memxor(TB, IV, CRYPTO_BLKSIZE);
-    memcpy(IV, in, CRYPTO_BLKSIZE);
-    memxor(IV, TB, CRYPTO_BLKSIZE);
-    memcpy(out, TB, CRYPTO_BLKSIZE);
+    while (count--) {
+        crypto_decrypt(TB, in);
+        xor_block(TB, TB, IV);
+        xor_block(IV, in, TB);
+        copy_block(out, TB);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
 }
 
 #elif (DFU_CIPHER_MODE == DFU_CIPHER_CFB)
 #define CRYPTO_MODE "-CFB"
 #define crypto_init_iv(dst, src, size) memcpy((dst), (src), (size))
-static void encrypt_block(void *out, const void *in) {
-    crypto_encrypt(IV, IV);
-    memxor(IV, in, CRYPTO_BLKSIZE);
-    memcpy(out, IV, CRYPTO_BLKSIZE);
+static void encrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
+    while (count--) {
+        crypto_encrypt(IV, IV);
+        xor_block(IV, IV, in);
+        copy_block(out, IV);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
 }
 
-static void decrypt_block(void *out, const void *in) {
+static void decrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
     uint32_t TB[CRYPTO_BLKSIZE32];
-    crypto_encrypt(TB, IV);
-    memcpy(IV, in, CRYPTO_BLKSIZE);
-    memxor(TB, IV, CRYPTO_BLKSIZE);
-    memcpy(out, TB, CRYPTO_BLKSIZE);
+    while (count--) {
+        crypto_encrypt(TB, IV);
+        copy_block(IV, in);
+        xor_block(out, TB, IV);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
 }
 
 #elif (DFU_CIPHER_MODE == DFU_CIPHER_OFB)
 #define CRYPTO_MODE "-OFB"
 #define crypto_init_iv(dst, src, size) memcpy((dst), (src), (size))
-static void encrypt_block(void *out, const void *in) {
-    uint32_t TB[CRYPTO_BLKSIZE32];
-    crypto_encrypt(IV, IV);
-    memcpy(TB, IV, CRYPTO_BLKSIZE);
-    memxor(TB, in, CRYPTO_BLKSIZE);
-    memcpy(out, TB, CRYPTO_BLKSIZE);
+static void encrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
+    while (count--) {
+        crypto_encrypt(IV, IV);
+        xor_block(out, in, IV);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
 }
 
-static void decrypt_block(void *out, const void *in) {
-    uint32_t TB[CRYPTO_BLKSIZE32];
-    crypto_encrypt(IV, IV);
-    memcpy(TB, in, CRYPTO_BLKSIZE);
-    memxor(TB, IV, CRYPTO_BLKSIZE);
-    memcpy(out, TB, CRYPTO_BLKSIZE);
+static void decrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
+    encrypt_blocks(out, in, count);
 }
 
 #elif (DFU_CIPHER_MODE == DFU_CIPHER_CTR)
 #define CRYPTO_MODE "-CTR"
 #define crypto_init_iv(dst, src, size) memcpy((dst), (src), (size))
-static void encrypt_block(void *out, const void *in) {
+#define crypto_seek(offset) counter_add(IV, (offset) / CRYPTO_BLKSIZE)
+/* whole IV is a little-endian counter */
+static void counter_add(uint32_t *ctr, size_t count) {
+    uint64_t acc = count;
+    for (int i = 0; i < CRYPTO_BLKSIZE32; i++) {
+        acc += ctr[i];
+        ctr[i] = (uint32_t)acc;
+        acc >>= 32;
+        if (acc == 0) break;
+    }
+}
+
+static void encrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
     uint32_t TB[CRYPTO_BLKSIZE32];
-    crypto_encrypt(TB, IV);
-    memxor(TB, in, CRYPTO_BLKSIZE);
-    memcpy(out, TB, CRYPTO_BLKSIZE);
-    IV[0]++;
+    while (count--) {
+        crypto_encrypt(TB, IV);
+        xor_block(out, in, TB);
+        counter_add(IV, 1);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
 }
 
-static void decrypt_block(void *out, const void *in) {
-    encrypt_block(out, in);
+static void decrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
+    encrypt_blocks(out, in, count);
 }
 
 #elif (DFU_CIPHER_MODE == DFU_CIPHER_ECB)
 #define CRYPTO_MODE "-ECB"
 #define crypto_init_iv(...)
-static void encrypt_block(void *out, const void *in) {
-    uint32_t TB[CRYPTO_BLKSIZE32];
-    memcpy(TB, in, CRYPTO_BLKSIZE);
-    crypto_encrypt(TB, TB);
-    memcpy(out, TB, CRYPTO_BLKSIZE);
+#define crypto_seek(...)
+static void encrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
+    while (count--) {
+        crypto_encrypt(out, in);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
 }
 
-static void decrypt_block(void *out, const void *in) {
-    uint32_t TB[CRYPTO_BLKSIZE32];
-    memcpy(TB, in, CRYPTO_BLKSIZE);
-    crypto_decrypt(TB, TB);
-    memcpy(out, TB, CRYPTO_BLKSIZE);
+static void decrypt_blocks(uint32_t *out, const uint32_t *in, size_t count) {
+    while (count--) {
+        crypto_decrypt(out, in);
+        out += CRYPTO_BLKSIZE32;
+        in += CRYPTO_BLKSIZE32;
+    }
+}
+
+#elif (DFU_CIPHER_MODE == DFU_CIPHER_AEAD)
+#include "poly1305.h"
+#define CRYPTO_MODE "-POLY1305"
+/* every DFU block is sealed separately with own nonce and one-time Poly1305
+ * key. The random image ID is xored into the last nonce words and the chunk
+ * index into the first one, so chunks can't be swapped within the image or
+ * taken from another one. The image ID comes in the nonce block sealed with
+ * the chunk index 0xFFFFFFFF before the data. Until it's opened the image ID
+ * is zero, that's used for the upload only. No additional data, so the MAC
+ * input is ciphertext || pad16 || le64(0) || le64(ciphertext length)
+ */
+#define AEAD_NONCE_CHUNK    0xFFFFFFFF
+static uint32_t chunk;
+static uint32_t image[2];
+#define crypto_init_iv(...) aead_init_iv()
+#undef  crypto_seek
+#define crypto_seek(offset) chunk = (offset) / DFU_BLOCKSZ
+
+static void aead_init_iv(void) {
+    chunk = 0;
+    image[0] = 0;
+    image[1] = 0;
+}
+
+static void encrypt_blocks(uint8_t *out, const uint8_t *in, size_t count) {
+    crypto_stream(out, in, count);
+}
+
+static void decrypt_blocks(uint8_t *out, const uint8_t *in, size_t count) {
+    crypto_stream(out, in, count);
+}
+
+static void aead_start(uint32_t index) {
+    uint32_t n[CRYPTO_IVSIZE / 4];
+    uint32_t otk[8];
+    memcpy(n, nonce, sizeof(n));
+    n[0] ^= index;
+    n[1] ^= image[0];
+    n[2] ^= image[1];
+    crypto_reset(key, n);
+    crypto_polykey(otk);
+    poly1305_init(otk);
+}
+
+static void aead_tag(void *tag, const void *data, size_t sz) {
+    static const uint8_t zero[16];
+    const uint32_t len[4] = {0, 0, (uint32_t)sz, 0};
+    poly1305_update(data, sz);
+    poly1305_update(zero, (0x10 - sz) & 0x0F);
+    poly1305_update(len, sizeof(len));
+    poly1305_finish(tag);
+}
+
+#elif (DFU_CIPHER_MODE == -1) && defined(crypto_stream)
+#define CRYPTO_MODE "-STREAM"
+#define crypto_init_iv(...)
+static void encrypt_blocks(uint8_t *out, const uint8_t *in, size_t count) {
+    crypto_stream(out, in, count);
+}
+
+static void decrypt_blocks(uint8_t *out, const uint8_t *in, size_t count) {
+    crypto_stream(out, in, count);
 }
 
 #elif (DFU_CIPHER_MODE == -1)
 #define CRYPTO_MODE "-STREAM"
 #define crypto_init_iv(...)
-static void encrypt_block(void *out, const void *in) {
-    crypto_encrypt(out, in);
+static void encrypt_blocks(uint8_t *out, const uint8_t *in, size_t count) {
+    while (count--) {
+        crypto_encrypt(out++, in++);
+    }
 }
 
-static void decrypt_block(void *out, const void *in) {
-    crypto_decrypt(out, in);
+static void decrypt_blocks(uint8_t *out, const uint8_t *in, size_t count) {
+    while (count--) {
+        crypto_decrypt(out++, in++);
+    }
 }
 
 #else
@@ -358,19 +488,15 @@ static void decrypt_block(void *out, const void *in) {
 #define CRYPTO_IVSIZE CRYPTO_BLKSIZE
 #endif
 
+/* block ciphers keeps expanded key. stream ciphers must restart keystream */
+#ifndef crypto_reset
+#define crypto_reset(...)
+#endif
+
 static const uint8_t key[CRYPTO_KEYSIZE] = {CRYPTO_KEY};
 static const uint8_t nonce[CRYPTO_IVSIZE] = {CRYPTO_NONCE};
 static uint32_t IV[CRYPTO_BLKSIZE32];
 
-static void* memxor(void *dst, const void *src, size_t sz) {
-    uint8_t *d = dst;
-    const uint8_t *s = src;
-    for (size_t i = 0; i < sz; i++) {
-        d[i] ^= s[i];
-    }
-    return d;
-}
-
 const char*    aes_name = CRYPTO_NAME CRYPTO_MODE;
 const size_t aes_blksize = CRYPTO_BLKSIZE;
 
@@ -379,18 +505,90 @@ void aes_init(void) {
     crypto_init(key, nonce);
 }
 
+void aes_reset(void) {
+    crypto_init_iv(IV, nonce, CRYPTO_BLKSIZE);
+    crypto_reset(key, nonce);
+}
+
+int aes_seek(size_t offset) {
+#if defined(crypto_seek)
+    crypto_init_iv(IV, nonce, CRYPTO_BLKSIZE);
+    crypto_seek(offset);
+    return 0;
+#else
+    (void)offset;
+    return -1;
+#endif
+}
+
 void aes_encrypt(void *out, const void *in, size_t sz) {
-    for (size_t i = 0; i < sz; i += CRYPTO_BLKSIZE) {
-        encrypt_block(out, in);
-        out += CRYPTO_BLKSIZE;
-        in += CRYPTO_BLKSIZE;
-    }
+    encrypt_blocks(out, in, sz / CRYPTO_BLKSIZE);
 }
 
 void aes_decrypt(void *out, const void *in, size_t sz) {
-    for (size_t i = 0; i < sz; i += CRYPTO_BLKSIZE) {
-        decrypt_block(out, in);
-        out += CRYPTO_BLKSIZE;
-        in += CRYPTO_BLKSIZE;
+    decrypt_blocks(out, in, sz / CRYPTO_BLKSIZE);
+}
+
+#if (DFU_CIPHER_MODE == DFU_CIPHER_AEAD)
+static int aead_check(const void *in, size_t sz) {
+    uint8_t tag[DFU_TAGSZ];
+    uint8_t diff = 0;
+    aead_tag(tag, in, sz);
+    for (int i = 0; i < DFU_TAGSZ; i++) {
+        diff |= tag[i] ^ ((const uint8_t*)in)[sz + i];
+    }
+    return diff ? -1 : 0;
+}
+#endif
+
+size_t aes_seal_nonce(void *out, const void *id) {
+#if (DFU_CIPHER_MODE == DFU_CIPHER_AEAD)
+    memset(out, 0, DFU_BLOCKSZ);
+    memcpy(out, id, sizeof(image));
+    memcpy(image, id, sizeof(image));
+    aead_start(AEAD_NONCE_CHUNK);
+    aead_tag((uint8_t*)out + DFU_BLOCKSZ, out, DFU_BLOCKSZ);
+    return DFU_BLOCKSZ + DFU_TAGSZ;
+#else
+    (void)out;
+    (void)id;
+    return 0;
+#endif
+}
+
+size_t aes_seal(void *out, const void *in, size_t sz) {
+#if (DFU_CIPHER_MODE == DFU_CIPHER_AEAD)
+    aead_start(chunk++);
+    encrypt_blocks(out, in, sz);
+    aead_tag((uint8_t*)out + sz, out, sz);
+    return sz + DFU_TAGSZ;
+#else
+    aes_encrypt(out, in, sz);
+    return sz;
+#endif
+}
+
+int aes_open(void *out, const void *in, size_t sz) {
+#if (DFU_CIPHER_MODE == DFU_CIPHER_AEAD)
+    if (sz < DFU_TAGSZ) return -1;
+    sz -= DFU_TAGSZ;
+    if ((image[0] | image[1]) == 0) {
+        /* nonce block of the image */
+        if (sz != DFU_BLOCKSZ) return -1;
+        memcpy(image, in, sizeof(image));
+        if ((image[0] | image[1]) != 0) {
+            aead_start(AEAD_NONCE_CHUNK);
+            if (aead_check(in, sz) == 0) return 0;
+        }
+        image[0] = 0;
+        image[1] = 0;
+        return -1;
     }
+    aead_start(chunk++);
+    if (aead_check(in, sz) != 0) return -1;
+    decrypt_blocks(out, in, sz);
+#else
+    aes_decrypt(out, in, sz);
+#endif
+    return sz;
 }
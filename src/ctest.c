@@ -1,6 +1,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #include "rc5.h"
 #include "gost.h"
@@ -15,6 +16,12 @@
 #include "rc6.h"
 #include "rijndael.h"
 #include "magma.h"
+#include "poly1305.h"
+#include "config.h"
+#include "crypto.h"
+#include "checksum.h"
+#include "patch.h"
+#include "bulk.h"
 
 #define _countof(x) (sizeof(x) / sizeof(*x))
 
@@ -27,6 +34,7 @@ typedef struct test_s {
     void (*init)(const void *key);
     void (*encrypt)(uint32_t*, const uint32_t*);
     void (*decrypt)(uint32_t*, const uint32_t*);
+    const size_t    tagsize;
 } test_t;
 
 /* wrappers for the stream ciphers */
@@ -56,6 +64,70 @@ static void chacha_enc_512(uint32_t* out, const uint32_t* in) {
     }
 }
 
+static void chacha_xor_512(uint32_t* out, const uint32_t* in) {
+    chacha_xor(out, in, 64);
+}
+
+static void chacha_init_sunscreen(const void* key) {
+    const uint8_t nonce[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00};
+    chacha_init(key, nonce);
+}
+
+static void chacha_xor_sunscreen(uint32_t* out, const uint32_t* in) {
+    chacha_xor(out, in, 114);
+}
+
+/* processes data chunks in the reverse order */
+static void chacha_seek_sunscreen(uint32_t* out, const uint32_t* in) {
+    const uint32_t chunks[] = {114, 100, 64, 63, 7, 0};
+    for (size_t i = 1; i < _countof(chunks); i++) {
+        uint32_t pos = chunks[i];
+        chacha_seek(pos);
+        chacha_xor((uint8_t*)out + pos, (const uint8_t*)in + pos, chunks[i - 1] - pos);
+    }
+}
+
+static void poly1305_mac_cfrg(uint32_t* out, const uint32_t* in) {
+    poly1305_update(in, 34);
+    poly1305_finish(out);
+}
+
+static void aead_init_sunscreen(const void* key) {
+    const uint8_t nonce[] = {0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+    chacha_init(key, nonce);
+}
+
+/* RFC8439 2.8 AEAD construction with 12 bytes of AAD */
+static void aead_tag_sunscreen(void *tag, const void *ct) {
+    const uint8_t aad[] = {0x50, 0x51, 0x52, 0x53, 0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7};
+    const uint32_t len[] = {sizeof(aad), 0, 114, 0};
+    const uint8_t zero[16] = {0};
+    uint32_t otk[8];
+    chacha_poly_key(otk);
+    poly1305_init(otk);
+    poly1305_update(aad, sizeof(aad));
+    poly1305_update(zero, 4);
+    poly1305_update(ct, 114);
+    poly1305_update(zero, 14);
+    poly1305_update(len, sizeof(len));
+    poly1305_finish(tag);
+}
+
+static void aead_seal_sunscreen(uint32_t* out, const uint32_t* in) {
+    chacha_xor(out, in, 114);
+    aead_tag_sunscreen((uint8_t*)out + 114, out);
+}
+
+static void aead_open_sunscreen(uint32_t* out, const uint32_t* in) {
+    uint8_t tag[16];
+    aead_tag_sunscreen(tag, in);
+    if (memcmp(tag, (const uint8_t*)in + 114, sizeof(tag)) == 0) {
+        chacha_xor(out, in, 114);
+    } else {
+        memset(out, 0, 114);
+    }
+}
+
 const test_t data[] = {
     {
         .blocksize = 8,
@@ -178,6 +250,113 @@ const test_t data[] = {
         .encrypt = chacha_enc_512,
         .decrypt = chacha_enc_512,
     },
+    {
+        .blocksize = 64,
+        .name    = "CHACHA-20 RFC7539 page 9 (block)",
+        .key     = "00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F"
+                   "10 11 12 13 14 15 16 17 18 19 1A 1B 1C 1D 1E 1F",
+        .plain   = "00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 "
+                   "00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 "
+                   "00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 "
+                   "00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00",
+        .cipher  = "10 F1 E7 E4 D1 3B 59 15 50 0F DD 1F A3 20 71 C4 "
+                   "C7 D1 F4 C7 33 C0 68 03 04 22 AA 9A C3 D4 6C 4E "
+                   "D2 82 64 46 07 9F AA 09 14 C2 D7 05 D9 8B 02 A2 "
+                   "B5 12 9C D1 DE 16 4E B9 CB D0 83 E8 A2 50 3C 4E",
+        .init    = chaha_init_512,
+        .encrypt = chacha_xor_512,
+        .decrypt = chacha_xor_512,
+    },
+    {
+        .blocksize = 114,
+        .name    = "CHACHA-20 RFC7539 2.4.2 (block)",
+        .key     = "00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F"
+                   "10 11 12 13 14 15 16 17 18 19 1A 1B 1C 1D 1E 1F",
+        .plain   = "4C 61 64 69 65 73 20 61 6E 64 20 47 65 6E 74 6C "
+                   "65 6D 65 6E 20 6F 66 20 74 68 65 20 63 6C 61 73 "
+                   "73 20 6F 66 20 27 39 39 3A 20 49 66 20 49 20 63 "
+                   "6F 75 6C 64 20 6F 66 66 65 72 20 79 6F 75 20 6F "
+                   "6E 6C 79 20 6F 6E 65 20 74 69 70 20 66 6F 72 20 "
+                   "74 68 65 20 66 75 74 75 72 65 2C 20 73 75 6E 73 "
+                   "63 72 65 65 6E 20 77 6F 75 6C 64 20 62 65 20 69 "
+                   "74 2E",
+        .cipher  = "6E 2E 35 9A 25 68 F9 80 41 BA 07 28 DD 0D 69 81 "
+                   "E9 7E 7A EC 1D 43 60 C2 0A 27 AF CC FD 9F AE 0B "
+                   "F9 1B 65 C5 52 47 33 AB 8F 59 3D AB CD 62 B3 57 "
+                   "16 39 D6 24 E6 51 52 AB 8F 53 0C 35 9F 08 61 D8 "
+                   "07 CA 0D BF 50 0D 6A 61 56 A3 8E 08 8A 22 B6 5E "
+                   "52 BC 51 4D 16 CC F8 06 81 8C E9 1A B7 79 37 36 "
+                   "5A F9 0B BF 74 A3 5B E6 B4 0B 8E ED F2 78 5E 42 "
+                   "87 4D",
+        .init    = chacha_init_sunscreen,
+        .encrypt = chacha_xor_sunscreen,
+        .decrypt = chacha_xor_sunscreen,
+    },
+    {
+        .blocksize = 114,
+        .name    = "CHACHA-20 RFC7539 2.4.2 (seek)",
+        .key     = "00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F"
+                   "10 11 12 13 14 15 16 17 18 19 1A 1B 1C 1D 1E 1F",
+        .plain   = "4C 61 64 69 65 73 20 61 6E 64 20 47 65 6E 74 6C "
+                   "65 6D 65 6E 20 6F 66 20 74 68 65 20 63 6C 61 73 "
+                   "73 20 6F 66 20 27 39 39 3A 20 49 66 20 49 20 63 "
+                   "6F 75 6C 64 20 6F 66 66 65 72 20 79 6F 75 20 6F "
+                   "6E 6C 79 20 6F 6E 65 20 74 69 70 20 66 6F 72 20 "
+                   "74 68 65 20 66 75 74 75 72 65 2C 20 73 75 6E 73 "
+                   "63 72 65 65 6E 20 77 6F 75 6C 64 20 62 65 20 69 "
+                   "74 2E",
+        .cipher  = "6E 2E 35 9A 25 68 F9 80 41 BA 07 28 DD 0D 69 81 "
+                   "E9 7E 7A EC 1D 43 60 C2 0A 27 AF CC FD 9F AE 0B "
+                   "F9 1B 65 C5 52 47 33 AB 8F 59 3D AB CD 62 B3 57 "
+                   "16 39 D6 24 E6 51 52 AB 8F 53 0C 35 9F 08 61 D8 "
+                   "07 CA 0D BF 50 0D 6A 61 56 A3 8E 08 8A 22 B6 5E "
+                   "52 BC 51 4D 16 CC F8 06 81 8C E9 1A B7 79 37 36 "
+                   "5A F9 0B BF 74 A3 5B E6 B4 0B 8E ED F2 78 5E 42 "
+                   "87 4D",
+        .init    = chacha_init_sunscreen,
+        .encrypt = chacha_seek_sunscreen,
+        .decrypt = chacha_seek_sunscreen,
+    },
+    {
+        .blocksize = 16,
+        .name    = "POLY1305 RFC8439 2.5.2",
+        .key     = "85 D6 BE 78 57 55 6D 33 7F 44 52 FE 42 D5 06 A8 "
+                   "01 03 80 8A FB 0D B2 FD 4A BF F6 AF 41 49 F5 1B",
+        .plain   = "43 72 79 70 74 6F 67 72 61 70 68 69 63 20 46 6F "
+                   "72 75 6D 20 52 65 73 65 61 72 63 68 20 47 72 6F "
+                   "75 70",
+        .cipher  = "A8 06 1D C1 30 51 36 C6 C2 2B 8B AF 0C 01 27 A9",
+        .init    = poly1305_init,
+        .encrypt = poly1305_mac_cfrg,
+        .tagsize = 16,
+    },
+    {
+        .blocksize = 130,
+        .name    = "CHACHA20-POLY1305 RFC8439 2.8.2",
+        .key     = "80 81 82 83 84 85 86 87 88 89 8A 8B 8C 8D 8E 8F "
+                   "90 91 92 93 94 95 96 97 98 99 9A 9B 9C 9D 9E 9F",
+        .plain   = "4C 61 64 69 65 73 20 61 6E 64 20 47 65 6E 74 6C "
+                   "65 6D 65 6E 20 6F 66 20 74 68 65 20 63 6C 61 73 "
+                   "73 20 6F 66 20 27 39 39 3A 20 49 66 20 49 20 63 "
+                   "6F 75 6C 64 20 6F 66 66 65 72 20 79 6F 75 20 6F "
+                   "6E 6C 79 20 6F 6E 65 20 74 69 70 20 66 6F 72 20 "
+                   "74 68 65 20 66 75 74 75 72 65 2C 20 73 75 6E 73 "
+                   "63 72 65 65 6E 20 77 6F 75 6C 64 20 62 65 20 69 "
+                   "74 2E",
+        .cipher  = "D3 1A 8D 34 64 8E 60 DB 7B 86 AF BC 53 EF 7E C2 "
+                   "A4 AD ED 51 29 6E 08 FE A9 E2 B5 A7 36 EE 62 D6 "
+                   "3D BE A4 5E 8C A9 67 12 82 FA FB 69 DA 92 72 8B "
+                   "1A 71 DE 0A 9E 06 0B 29 05 D6 A5 B6 7E CD 3B 36 "
+                   "92 DD BD 7F 2D 77 8B 8C 98 03 AE E3 28 09 1B 58 "
+                   "FA B3 24 E4 FA D6 75 94 55 85 80 8B 48 31 D7 BC "
+                   "3F F4 DE F0 8E 4B 7A 9D E5 76 D2 65 86 CE C6 4B "
+                   "61 16 "
+                   "1A E1 0B 59 4F 09 E2 6A 7E 90 2E CB D0 60 06 91",
+        .init    = aead_init_sunscreen,
+        .encrypt = aead_seal_sunscreen,
+        .decrypt = aead_open_sunscreen,
+        .tagsize = 16,
+    },
     {
         .blocksize = 16,
         .name    = "RC6-32/20/16 IETF",
@@ -320,21 +499,497 @@ int test(const test_t* algo) {
         ret = -1;
     }
 
-    algo->init(key);
-    algo->decrypt(buf, ct);
-    if (memcmp(buf, pt, algo->blocksize) != 0) {
-        batostr(buf, msg, algo->blocksize);
-        printf("\nDecrypt error.\nExpect %s\n   Got %s", algo->plain, msg);
-        ret = -1;
+    /* authenticated output is longer than plain data by the tag size */
+    if (algo->decrypt != NULL) {
+        algo->init(key);
+        algo->decrypt(buf, ct);
+        if (memcmp(buf, pt, algo->blocksize - algo->tagsize) != 0) {
+            batostr(buf, msg, algo->blocksize - algo->tagsize);
+            printf("\nDecrypt error.\nExpect %s\n   Got %s", algo->plain, msg);
+            ret = -1;
+        }
     }
     printf(" %s\n", (ret == 0) ? "PASS" : "\nFAIL");
     return ret;
 }
 
+/* checks random access to the configured cipher */
+int test_seek(void) {
+    uint32_t pt[0x80];
+    uint32_t ct[0x80];
+    uint32_t buf[0x80];
+    size_t blk = (aes_blksize + 3) & ~3;
+    size_t count = sizeof(pt) / blk;
+    int ret = 0;
+
+    printf("Testing %s random access ...", aes_name);
+    aes_init();
+    /* authenticated mode is checked by test_auth() */
+    if ((DFU_TAGSZ != 0) || (aes_seek(0) != 0)) {
+        printf(" SKIP\n");
+        return 0;
+    }
+    for (size_t i = 0; i < _countof(pt); i++) {
+        pt[i] = 0x9E3779B9 * i;
+    }
+    aes_encrypt(ct, pt, count * blk);
+    for (size_t i = 0; i < count; i++) {
+        /* odd blocks first, then even ones */
+        size_t j = (i < count / 2) ? 2 * i + 1 : 2 * (i - count / 2);
+        aes_seek(j * blk);
+        aes_decrypt((uint8_t*)buf + j * blk, (uint8_t*)ct + j * blk, blk);
+    }
+    if (memcmp(buf, pt, count * blk) != 0) {
+        ret = -1;
+    }
+    printf(" %s\n", (ret == 0) ? "PASS" : "FAIL");
+    return ret;
+}
+
+/* checks sealed DFU blocks of the configured cipher */
+int test_auth(void) {
+    /* nonce block and four DFU blocks, sizes in bytes */
+    const size_t count = 4;
+    const size_t chunk = DFU_BLOCKSZ + DFU_TAGSZ;
+    const uint32_t id[2][2] = {{0x01234567, 0x89ABCDEF}, {0x01234567, 0x89ABCDEE}};
+    uint32_t pt[4 * DFU_BLOCKSZ / 4];
+    uint32_t ct[2][5 * (DFU_BLOCKSZ + DFU_TAGSZ) / 4];
+    uint32_t buf[(DFU_BLOCKSZ + DFU_TAGSZ) / 4];
+    int ret = 0;
+
+    printf("Testing %s sealed blocks ...", aes_name);
+    if (DFU_TAGSZ == 0) {
+        printf(" SKIP\n");
+        return 0;
+    }
+    for (size_t i = 0; i < _countof(pt); i++) {
+        pt[i] = 0x9E3779B9 * i;
+    }
+    /* the same data in two images */
+    aes_init();
+    for (size_t n = 0; n < 2; n++) {
+        aes_reset();
+        if (aes_seal_nonce(ct[n], id[n]) != chunk) {
+            ret = -1;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (aes_seal((uint8_t*)ct[n] + (i + 1) * chunk, (uint8_t*)pt + i * DFU_BLOCKSZ, DFU_BLOCKSZ) != chunk) {
+                ret = -1;
+            }
+        }
+    }
+    if (memcmp((uint8_t*)ct[0] + chunk, (uint8_t*)ct[1] + chunk, DFU_BLOCKSZ) == 0) {
+        ret = -1;
+    }
+    /* in the reverse order, in place. The nonce block goes first */
+    for (size_t i = count; i-- > 0; ) {
+        aes_seek(i * DFU_BLOCKSZ);
+        memcpy(buf, ct[0], chunk);
+        if (aes_open(buf, buf, chunk) != 0) {
+            ret = -1;
+        }
+        memcpy(buf, (uint8_t*)ct[0] + (i + 1) * chunk, chunk);
+        if (aes_open(buf, buf, chunk) != DFU_BLOCKSZ ||
+            memcmp(buf, (uint8_t*)pt + i * DFU_BLOCKSZ, DFU_BLOCKSZ) != 0) {
+            ret = -1;
+        }
+    }
+    /* tampered nonce block, data and tag must be rejected */
+    for (size_t pos = 0; pos < chunk; pos += 7) {
+        aes_reset();
+        memcpy(buf, ct[0], chunk);
+        ((uint8_t*)buf)[pos] ^= 0x01;
+        if (aes_open(buf, buf, chunk) != -1) {
+            ret = -1;
+        }
+        aes_reset();
+        memcpy(buf, ct[0], chunk);
+        aes_open(buf, buf, chunk);
+        memcpy(buf, (uint8_t*)ct[0] + chunk, chunk);
+        ((uint8_t*)buf)[pos] ^= 0x01;
+        if (aes_open(buf, buf, chunk) != -1) {
+            ret = -1;
+        }
+    }
+    /* data without the nonce block, swapped blocks and blocks of another image */
+    aes_reset();
+    memcpy(buf, (uint8_t*)ct[0] + chunk, chunk);
+    if (aes_open(buf, buf, chunk) != -1) {
+        ret = -1;
+    }
+    aes_reset();
+    memcpy(buf, ct[0], chunk);
+    aes_open(buf, buf, chunk);
+    memcpy(buf, (uint8_t*)ct[0] + 2 * chunk, chunk);
+    if (aes_open(buf, buf, chunk) != -1) {
+        ret = -1;
+    }
+    aes_reset();
+    memcpy(buf, ct[0], chunk);
+    aes_open(buf, buf, chunk);
+    memcpy(buf, (uint8_t*)ct[1] + chunk, chunk);
+    if (aes_open(buf, buf, chunk) != -1) {
+        ret = -1;
+    }
+    printf(" %s\n", (ret == 0) ? "PASS" : "FAIL");
+    return ret;
+}
+
+/* checks image header and checksum */
+int test_checksum(void) {
+    uint32_t img[0x100] = {0};
+    size_t len = sizeof(img) - 0x20;
+    int ret = 0;
+
+    printf("Testing %s image checksum ...", checksum_name);
+    if (DFU_VERIFY_CHECKSUM == _DISABLE) {
+        printf(" SKIP\n");
+        return 0;
+    }
+    for (size_t i = 0; i < len / 4; i++) {
+        if ((i < 7) || (i > 10)) img[i] = 0x9E3779B9 * i;
+    }
+    if (append_checksum(img, len, sizeof(img)) != len + checksum_length) {
+        ret = -1;
+    }
+    if (validate_checksum(img, sizeof(img)) != len) {
+        ret = -1;
+    }
+    /* device digests. Raw data matches while the boot record area is erased */
+    uint8_t digest[8];
+    if ((checksum_image(digest, img, sizeof(img)) != len) ||
+        memcmp(digest, (uint8_t*)img + len, checksum_length)) {
+        ret = -1;
+    }
+    checksum_region(digest, img, len);
+    if (memcmp(digest, (uint8_t*)img + len, checksum_length)) {
+        ret = -1;
+    }
+    /* streamed in odd pieces with the padding tail */
+    checksum_init();
+    for (size_t pos = 0; pos < sizeof(img); pos += 13) {
+        size_t sz = sizeof(img) - pos;
+        checksum_update((uint8_t*)img + pos, (sz > 13) ? 13 : sz);
+    }
+    if (checksum_final() != len) {
+        ret = -1;
+    }
+    /* incomplete stream */
+    checksum_init();
+    checksum_update(img, len);
+    if (checksum_final() != 0) {
+        ret = -1;
+    }
+    /* boot record area is not covered */
+    img[8] = 0x12345678;
+    if (validate_checksum(img, sizeof(img)) != len) {
+        ret = -1;
+    }
+    /* data truncated by the buffer size */
+    if (validate_checksum(img, len) != 0) {
+        ret = -1;
+    }
+    ((uint8_t*)img)[len / 2] ^= 0x01;
+    if (validate_checksum(img, sizeof(img)) != 0) {
+        ret = -1;
+    }
+    checksum_init();
+    checksum_update(img, sizeof(img));
+    if (checksum_final() != 0) {
+        ret = -1;
+    }
+    printf(" %s\n", (ret == 0) ? "PASS" : "FAIL");
+    return ret;
+}
+
+/* patch round trip over the image in place */
+static uint8_t patch_img[0x1000];
+
+static uint8_t patch_write(size_t offset, const void *data, size_t len) {
+    memcpy(&patch_img[offset], data, len);
+    return PATCH_OK;
+}
+
+static uint8_t patch_apply(const uint8_t *p, size_t len, size_t base_length) {
+    static uint32_t window[0x40];
+    patch_init(patch_img, patch_img, sizeof(patch_img), window, sizeof(window), base_length, 0, patch_write);
+    for (size_t pos = 0; pos < len; pos += 13) {
+        uint8_t res = patch_update(p + pos, (len - pos > 13) ? 13 : len - pos);
+        if (res != PATCH_OK) {
+            return res;
+        }
+    }
+    return patch_final();
+}
+
+int test_patch(void) {
+    static uint8_t old[sizeof(patch_img)], img[sizeof(patch_img)], p[2 * sizeof(patch_img)];
+    size_t len = sizeof(img) - 0x40;
+    int ret = 0;
+
+    printf("Testing delta patch and compression ...");
+    for (size_t i = 0; i < sizeof(old); i++) {
+        old[i] = (0x9E3779B9 * (i / 3)) >> 24;
+    }
+    /* inserted data shifts the rest of the image */
+    memcpy(img, old, 0x600);
+    memset(&img[0x600], 0x5A, 0x40);
+    memcpy(&img[0x640], &old[0x600], len - 0x640);
+    img[0x10] ^= 0xFF;
+    size_t plen = patch_encode(p, sizeof(p), img, len, old, sizeof(old), 0x100);
+    if ((plen == 0) || (plen > len / 4)) {
+        ret = -1;
+    }
+    memcpy(patch_img, old, sizeof(old));
+    if ((patch_apply(p, plen, 0) != PATCH_OK) || memcmp(patch_img, img, len)) {
+        ret = -1;
+    }
+    /* window of the device is larger */
+    memcpy(patch_img, old, sizeof(old));
+    plen = patch_encode(p, sizeof(p), img, len, old, sizeof(old), 0x80);
+    if ((patch_apply(p, plen, 0) != PATCH_OK) || memcmp(patch_img, img, len)) {
+        ret = -1;
+    }
+    /* incomplete patch */
+    if (patch_apply(p, plen - 1, 0) != PATCH_ERR_NOTDONE) {
+        ret = -1;
+    }
+    /* made for another base */
+    ((struct patch_header*)p)->base_length = 0x100;
+    if (patch_apply(p, plen, 0x200) != PATCH_ERR_FILE) {
+        ret = -1;
+    }
+    /* compressed image. Matches reach below the window */
+    memcpy(&img[0x800], &img[0x100], 0x200);
+    memset(&img[0xA00], 0x00, len - 0xA00);
+    plen = patch_encode(p, sizeof(p), img, len, NULL, 0, 0x100);
+    memset(patch_img, 0xA5, sizeof(patch_img));
+    if ((plen == 0) || (plen > len / 2) || (patch_apply(p, plen, 0) != PATCH_OK) || memcmp(patch_img, img, len)) {
+        ret = -1;
+    }
+    /* copy from the overwritten window */
+    static const uint8_t below[] = {PATCH_OP_COPY, 0x80, 0x02, 0x00, PATCH_OP_COPY, 0x10, 0x00};
+    plen = patch_encode(p, sizeof(p), img, 0, old, 0, 0x100);
+    memcpy(&p[plen], below, sizeof(below));
+    ((struct patch_header*)p)->size = plen + sizeof(below);
+    ((struct patch_header*)p)->length = 0x110;
+    if (patch_apply(p, plen + sizeof(below), 0) != PATCH_ERR_ADDRESS) {
+        ret = -1;
+    }
+    printf(" %s\n", (ret == 0) ? "PASS" : "FAIL");
+    return ret;
+}
+
+/* simulated device for the bulk transport */
+static struct {
+    struct bulk_rx  rx;
+    uint8_t         block[0x90];
+    uint8_t         img[0x800];
+    size_t          len;
+    struct bulk_ack ack[0x10];
+    unsigned        head;
+    unsigned        tail;
+    unsigned        maxpend;
+    uint16_t        fail;
+    uint8_t         status;
+    bool            done;
+} bsim;
+
+static void bsim_init(uint16_t fail) {
+    memset(&bsim, 0, sizeof(bsim));
+    bsim.fail = fail;
+    bulk_rx_init(&bsim.rx, bsim.block, sizeof(bsim.block));
+}
+
+static void bsim_block(void) {
+    uint16_t len = bsim.rx.hdr.wLength;
+    if (bsim.status != 0) {
+        /* error is kept until cleared */
+    } else if ((len > sizeof(bsim.block)) || (bsim.len + len > sizeof(bsim.img))) {
+        bsim.status = 15;
+    } else if (bsim.rx.hdr.wBlockNum == bsim.fail) {
+        bsim.status = 7;
+    } else if (len == 0) {
+        bsim.done = true;
+    } else {
+        memcpy(&bsim.img[bsim.len], bsim.block, len);
+        bsim.len += len;
+    }
+    struct bulk_ack *ack = &bsim.ack[bsim.tail++ % _countof(bsim.ack)];
+    ack->wBlockNum = bsim.rx.hdr.wBlockNum;
+    ack->bStatus = bsim.status;
+    ack->bState = (bsim.status != 0) ? 10 : (bsim.done) ? 2 : 5;
+    if (bsim.tail - bsim.head > bsim.maxpend) {
+        bsim.maxpend = bsim.tail - bsim.head;
+    }
+    bulk_rx_init(&bsim.rx, bsim.block, sizeof(bsim.block));
+}
+
+/* splits the transfer to the endpoint sized packets */
+static int bsim_send(void *ctx, const void *data, size_t len) {
+    const uint8_t *src = data;
+    (void)ctx;
+    for (size_t pos = 0; pos < len; pos += BULK_EP_SIZE) {
+        size_t pkt = (len - pos > BULK_EP_SIZE) ? BULK_EP_SIZE : len - pos;
+        for (size_t cnt = 0; cnt < pkt; ) {
+            cnt += bulk_rx_feed(&bsim.rx, &src[pos + cnt], pkt - cnt);
+            if (bulk_rx_done(&bsim.rx)) {
+                bsim_block();
+            }
+        }
+    }
+    return 0;
+}
+
+static int bsim_recv(void *ctx, struct bulk_ack *ack) {
+    (void)ctx;
+    if (bsim.head == bsim.tail) {
+        return -1;
+    }
+    *ack = bsim.ack[bsim.head++ % _countof(bsim.ack)];
+    return 0;
+}
+
+int test_bulk(void) {
+    static const struct bulk_link link = {NULL, bsim_send, bsim_recv};
+    uint8_t img[0x500];
+    int ret = 0;
+
+    printf("Testing bulk transport ...");
+    for (size_t i = 0; i < sizeof(img); i++) {
+        img[i] = (0x9E3779B9 * i) >> 24;
+    }
+    /* blocks are not aligned to the packets */
+    bsim_init(0);
+    if ((bulk_download(&link, img, sizeof(img), sizeof(bsim.block)) != 0) || !bsim.done ||
+        (bsim.len != sizeof(img)) || memcmp(bsim.img, img, sizeof(img)) ||
+        (bsim.maxpend > BULK_WINDOW) || (bsim.head != bsim.tail)) {
+        ret = -1;
+    }
+    /* length is a multiple of the block size */
+    bsim_init(0);
+    if ((bulk_download(&link, img, 0x400, 0x80) != 0) || !bsim.done ||
+        (bsim.len != 0x400) || memcmp(bsim.img, img, 0x400)) {
+        ret = -1;
+    }
+    /* device error stops the download within the window */
+    bsim_init(BULK_FIRST_BLOCK + 3);
+    if ((bulk_download(&link, img, sizeof(img), 0x80) != 7) || bsim.done ||
+        (bsim.tail > 3 + 1 + BULK_WINDOW)) {
+        ret = -1;
+    }
+    /* block is larger than the device buffer */
+    bsim_init(0);
+    if (bulk_download(&link, img, sizeof(img), 0x100) != 15) {
+        ret = -1;
+    }
+    printf(" %s\n", (ret == 0) ? "PASS" : "FAIL");
+    return ret;
+}
+
+/* benchmarking */
+#define BENCH_BATCH 0x40
+#define BENCH_TIME  (CLOCKS_PER_SEC / 10)
+
+static void aes_init_wrap(const void *arg) {
+    (void)arg;
+    aes_init();
+}
+
+static void aes_reset_wrap(const void *arg) {
+    (void)arg;
+    aes_reset();
+}
+
+static uint32_t bench_buf[0x400];
+
+static void aes_decrypt_wrap(const void *arg) {
+    (void)arg;
+    aes_decrypt(bench_buf, bench_buf, sizeof(bench_buf));
+}
+
+static void chacha_bytes_wrap(const void *arg) {
+    uint8_t *b = (uint8_t*)bench_buf;
+    (void)arg;
+    for (size_t i = 0; i < sizeof(bench_buf); i++) {
+        chacha_crypt(b + i, b + i);
+    }
+}
+
+static void chacha_xor_wrap(const void *arg) {
+    (void)arg;
+    chacha_xor(bench_buf, bench_buf, sizeof(bench_buf));
+}
+
+/* returns average call time in microseconds */
+static double bench(void (*fn)(const void*), const void *arg) {
+    size_t count = 0;
+    clock_t elapsed;
+    clock_t start = clock();
+    do {
+        for (int i = 0; i < BENCH_BATCH; i++) {
+            fn(arg);
+        }
+        count += BENCH_BATCH;
+        elapsed = clock() - start;
+    } while (elapsed < BENCH_TIME);
+    return (1e6 * elapsed) / ((double)CLOCKS_PER_SEC * count);
+}
+
+static void bench_stream(const char *name, void (*fn)(const void*)) {
+    double us = bench(fn, NULL);
+    printf("  %-50s %10.3f MB/s", name, sizeof(bench_buf) / us);
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t tsc = __builtin_ia32_rdtsc();
+    fn(NULL);
+    tsc = __builtin_ia32_rdtsc() - tsc;
+    printf(" %7.3f bytes/cycle", (double)sizeof(bench_buf) / tsc);
+#endif
+    printf("\n");
+}
+
+static uint32_t bench_img[_countof(bench_buf)];
+
+static void checksum_wrap(const void *arg) {
+    (void)arg;
+    validate_checksum(bench_img, sizeof(bench_img));
+}
+
+void benchmark(void) {
+    uint8_t key[0x80];
+    printf("\nDFU request latency for %s\n", aes_name);
+    printf("  %-50s %10.3f us\n", "aes_init() key schedule and IV", bench(aes_init_wrap, NULL));
+    printf("  %-50s %10.3f us\n", "aes_reset() IV only", bench(aes_reset_wrap, NULL));
+    aes_init();
+    bench_stream("aes_decrypt() 4 KiB", aes_decrypt_wrap);
+    printf("\nKey schedule time saved per DFU request\n");
+    for (size_t i = 0; i < _countof(data); i++) {
+        strtoba(data[i].key, key);
+        printf("  %-50s %10.3f us\n", data[i].name, bench(data[i].init, key));
+    }
+    printf("\nCHACHA-20 throughput\n");
+    chacha_init(key, key);
+    bench_stream("chacha_crypt() byte by byte", chacha_bytes_wrap);
+    bench_stream("chacha_xor() 64-byte blocks", chacha_xor_wrap);
+    if (DFU_VERIFY_CHECKSUM != _DISABLE) {
+        printf("\n%s checksum throughput\n", checksum_name);
+        append_checksum(bench_img, sizeof(bench_img) - 0x10, sizeof(bench_img));
+        bench_stream("validate_checksum()", checksum_wrap);
+    }
+}
+
 int main(int argc, char **argv) {
     int ret = 0;
     for (int i = 0; i < _countof(data); i++) {
         ret |= test(&data[i]);
     }
+    ret |= test_seek();
+    ret |= test_auth();
+    ret |= test_checksum();
+    ret |= test_patch();
+    ret |= test_bulk();
+    if ((argc > 1) && (strcmp(argv[1], "-b") == 0)) {
+        benchmark();
+    }
     return ret;
 }
\ No newline at end of file
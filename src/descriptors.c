@@ -21,6 +21,7 @@
 #include "usb.h"
 #include "usb_dfu.h"
 #include "usb_msft.h"
+#include "bulk.h"
 
 /* Checking for the EEPROM */
 #if (defined(DATA_EEPROM_BASE) || defined(FLASH_EEPROM_BASE)) && (DFU_INTF_EEPROM != _DISABLE)
@@ -57,6 +58,11 @@ struct config_desc {
     struct usb_interface_descriptor eeprom;
 #endif
     struct usb_dfu_func_desc        dfufunc;
+#if (DFU_BULK == _ENABLE)
+    struct usb_interface_descriptor bulk;
+    struct usb_endpoint_descriptor  bulk_out;
+    struct usb_endpoint_descriptor  bulk_in;
+#endif
 } __attribute__((packed));
 
 static const struct usb_device_descriptor dfu_device_desc = {
@@ -81,7 +87,11 @@ static const struct config_desc dfu_config_desc = {
         .bLength                = sizeof(struct usb_config_descriptor),
         .bDescriptorType        = USB_DTYPE_CONFIGURATION,
         .wTotalLength           = sizeof(struct config_desc),
+#if (DFU_BULK == _ENABLE)
+        .bNumInterfaces         = 2,
+#else
         .bNumInterfaces         = 1,
+#endif
         .bConfigurationValue    = 1,
         .iConfiguration         = _CONF_IDX,
         .bmAttributes           = USB_CFG_ATTR_RESERVED | USB_CFG_ATTR_SELFPOWERED,
@@ -120,9 +130,42 @@ static const struct config_desc dfu_config_desc = {
         .bmAttributes           = USB_DFU_ATTR_CAN_DNLOAD | USB_DFU_ATTR_MANIF_TOL,
 #endif
         .wDetachTimeout         = DFU_DETACH_TIMEOUT,
-        .wTransferSize          = DFU_BLOCKSZ,
+        .wTransferSize          = DFU_BLOCKSZ + DFU_TAGSZ,
+#if (DFU_DFUSE == _ENABLE)
+        .bcdDFUVersion          = 0x011A,
+#else
         .bcdDFUVersion          = VERSION_BCD(1,1,0),
+#endif
+    },
+#if (DFU_BULK == _ENABLE)
+    .bulk = {
+        .bLength                = sizeof(struct usb_interface_descriptor),
+        .bDescriptorType        = USB_DTYPE_INTERFACE,
+        .bInterfaceNumber       = 1,
+        .bAlternateSetting      = 0,
+        .bNumEndpoints          = 2,
+        .bInterfaceClass        = USB_CLASS_VENDOR,
+        .bInterfaceSubClass     = USB_SUBCLASS_VENDOR,
+        .bInterfaceProtocol     = USB_PROTO_VENDOR,
+        .iInterface             = NO_DESCRIPTOR,
+    },
+    .bulk_out = {
+        .bLength                = sizeof(struct usb_endpoint_descriptor),
+        .bDescriptorType        = USB_DTYPE_ENDPOINT,
+        .bEndpointAddress       = BULK_EP_OUT,
+        .bmAttributes           = USB_EPTYPE_BULK,
+        .wMaxPacketSize         = BULK_EP_SIZE,
+        .bInterval              = 0x00,
+    },
+    .bulk_in = {
+        .bLength                = sizeof(struct usb_endpoint_descriptor),
+        .bDescriptorType        = USB_DTYPE_ENDPOINT,
+        .bEndpointAddress       = BULK_EP_IN,
+        .bmAttributes           = USB_EPTYPE_BULK,
+        .wMaxPacketSize         = BULK_EP_SIZE,
+        .bInterval              = 0x00,
     },
+#endif
 };
 
 static const struct usb_string_descriptor dfu_lang_sdesc    = USB_ARRAY_DESC(USB_LANGID_ENG_US);
@@ -160,12 +203,18 @@ static const struct usb_string_descriptor dfu_msft_sdesc  = {
     .wString = u"MSFT100\x00\x00"
 };
 
+#if (DFU_BULK == _ENABLE)
+    #define _WCID_SECTIONS  2
+#else
+    #define _WCID_SECTIONS  1
+#endif
+
 static const struct usb_msft_compat_id_desc dfu_msft_compat_id_desc = {
     .dwLength = (USB_MSFT_COMPAT_ID_HEADER_SIZE +
-                 1*USB_MSFT_COMPAT_ID_FUNCTION_SECTION_SIZE),
+                 _WCID_SECTIONS*USB_MSFT_COMPAT_ID_FUNCTION_SECTION_SIZE),
     .bcdVersion = 0x0100,
     .wIndex = 0x0004,
-    .bNumSections = 1,
+    .bNumSections = _WCID_SECTIONS,
     .reserved = { 0, 0, 0, 0, 0, 0, 0 },
     .functions = {
         {
@@ -175,6 +224,15 @@ static const struct usb_msft_compat_id_desc dfu_msft_compat_id_desc = {
             .subCompatibleId = "",
             .reserved1 = { 0, 0, 0, 0, 0, 0}
         },
+#if (DFU_BULK == _ENABLE)
+        {
+            .bInterfaceNumber = 1,
+            .reserved0 = { 1 },
+            .compatibleId = "WINUSB",
+            .subCompatibleId = "",
+            .reserved1 = { 0, 0, 0, 0, 0, 0}
+        },
+#endif
     }
 };
 #endif
@@ -13,6 +13,9 @@
  * limitations under the License.
  */
 
+#if defined(_WIN32)
+#define _CRT_RAND_S
+#endif
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -21,6 +24,24 @@
 #include "config.h"
 #include "crypto.h"
 #include "checksum.h"
+#include "patch.h"
+#include "dfu_vendor.h"
+#include "crctable.h"
+
+/* default patch window of the bootloader */
+#define PATCH_WINDOW    0x400
+
+/* sealed image size, the tags and the nonce block are added */
+#if (DFU_TAGSZ != 0)
+    #define SEALED_LEN(len) ((len) + DFU_TAGSZ * ((len) / DFU_BLOCKSZ + 2) + DFU_BLOCKSZ)
+#else
+    #define SEALED_LEN(len) (len)
+#endif
+
+/* erased flash value of the target. 0x00 for STM32L0/L1, set by the Makefile */
+#if !defined(ERASED_BYTE)
+    #define ERASED_BYTE     0xFF
+#endif
 
 
 typedef struct {
@@ -35,12 +56,17 @@ typedef struct {
 
 static void exithelp(void) {
     printf("Usage: fwcrypt [options] -i infile -o outfile\n"
+           "\t infile is a binary, ELF or Intel HEX file\n"
            "\t -e Encrypt (default)\n"
            "\t -d Decrypt\n"
            "\t -n No output (dry run)\n"
            "\t -c Without checksum signature\n"
            "\t -C Skip encryption/decryption\n"
            "\t -v VID:PID append DFU suffix (encrypt only)\n"
+           "\t -D oldfile make a patch from oldfile to infile (encrypt only)\n"
+           "\t -z compress image (encrypt only, default for ELF and HEX input with DFU_PATCH)\n"
+           "\t -w size patch window size (default 0x%X)\n",
+           PATCH_WINDOW
     );
     exit(0);
 }
@@ -59,6 +85,23 @@ static char *strsign(const void *data, size_t len) {
     return s;
 }
 
+#if (DFU_VERIFY_CHECKSUM != _DISABLE)
+/* DFU_VENDOR_GETDIGEST answer for the region holding the programmed image */
+static void print_digest(const uint8_t *img, size_t len) {
+    size_t units = (len + DFU_DIGEST_UNIT - 1) / DFU_DIGEST_UNIT;
+    uint8_t digest[8];
+    uint8_t *region = malloc(units * DFU_DIGEST_UNIT);
+    if (region == NULL) {
+        return;
+    }
+    memset(region, ERASED_BYTE, units * DFU_DIGEST_UNIT);
+    memcpy(region, img, len);
+    checksum_region(digest, region, units * DFU_DIGEST_UNIT);
+    printf("Region digest: %zd units, (%s) %s\n", units, checksum_name, strsign(digest, checksum_length));
+    free(region);
+}
+#endif
+
 static uint32_t get_vidpid(const char *data) {
     uint32_t vid, pid;
     if (2 == sscanf(data, "%x:%x", &vid, &pid)) {
@@ -69,50 +112,7 @@ static uint32_t get_vidpid(const char *data) {
     return 0;
 }
 
-static const uint32_t crc_table[] = {
-0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
-0xe963a535, 0x9e6495a3, 0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
-0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91, 0x1db71064, 0x6ab020f2,
-0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
-0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9,
-0xfa0f3d63, 0x8d080df5, 0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
-0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b, 0x35b5a8fa, 0x42b2986c,
-0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
-0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423,
-0xcfba9599, 0xb8bda50f, 0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
-0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d, 0x76dc4190, 0x01db7106,
-0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d,
-0x91646c97, 0xe6635c01, 0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
-0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457, 0x65b0d9c6, 0x12b7e950,
-0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
-0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7,
-0xa4d1c46d, 0xd3d6f4fb, 0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
-0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9, 0x5005713c, 0x270241aa,
-0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
-0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81,
-0xb7bd5c3b, 0xc0ba6cad, 0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
-0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683, 0xe3630b12, 0x94643b84,
-0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb,
-0x196c3671, 0x6e6b06e7, 0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
-0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5, 0xd6d6a3e8, 0xa1d1937e,
-0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
-0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55,
-0x316e8eef, 0x4669be79, 0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
-0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f, 0xc5ba3bbe, 0xb2bd0b28,
-0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
-0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f,
-0x72076785, 0x05005713, 0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
-0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21, 0x86d3d2d4, 0xf1d4e242,
-0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69,
-0x616bffd3, 0x166ccf45, 0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
-0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db, 0xaed16a4a, 0xd9d65adc,
-0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
-0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693,
-0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
-0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d};
+static const uint32_t crc_table[0x100] = { CRC32_TABLE0 };
 
 
 static uint32_t compute_dfu_crc(const void *data, size_t length) {
@@ -125,6 +125,340 @@ static uint32_t compute_dfu_crc(const void *data, size_t length) {
 }
 
 
+/* ELF and Intel HEX input is converted to the flat image. Gaps between the
+ * segments are filled with the erased flash value. The first pass finds the address range, the
+ * second one copies the data.
+ */
+typedef struct {
+    uint8_t  *buf;
+    uint32_t lo;
+    uint32_t hi;
+} flat_t;
+
+static void flat_put(flat_t *f, uint32_t addr, const void *data, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    if (f->buf == NULL) {
+        if (addr < f->lo) {
+            f->lo = addr;
+        }
+        if (addr + len > f->hi) {
+            f->hi = addr + len;
+        }
+    } else {
+        memcpy(&f->buf[addr - f->lo], data, len);
+    }
+}
+
+static uint32_t get_le(const uint8_t *data, int n) {
+    uint32_t v = 0;
+    while (n--) {
+        v = (v << 8) | data[n];
+    }
+    return v;
+}
+
+/* loadable segments of the 32-bit little-endian ELF at their load addresses */
+static int parse_elf(const uint8_t *data, size_t len, flat_t *f) {
+    if ((len < 0x34) || (data[4] != 1) || (data[5] != 1)) {
+        return -1;
+    }
+    uint32_t phoff = get_le(&data[28], 4);
+    uint32_t phentsize = get_le(&data[42], 2);
+    uint32_t phnum = get_le(&data[44], 2);
+    for (uint32_t i = 0; i < phnum; i++) {
+        if ((phoff + (i + 1) * phentsize > len) || (phentsize < 0x20)) {
+            return -1;
+        }
+        const uint8_t *ph = &data[phoff + i * phentsize];
+        uint32_t offset = get_le(&ph[4], 4);
+        uint32_t filesz = get_le(&ph[16], 4);
+        if ((get_le(&ph[0], 4) != 1) || (filesz == 0)) {
+            /* not PT_LOAD or no data */
+            continue;
+        }
+        if ((offset > len) || (filesz > len - offset)) {
+            return -1;
+        }
+        flat_put(f, get_le(&ph[12], 4), &data[offset], filesz);
+    }
+    return 0;
+}
+
+static int get_hex(const char *s, size_t n) {
+    int v = 0;
+    while (n--) {
+        char c = *s++;
+        v <<= 4;
+        if ((c >= '0') && (c <= '9')) {
+            v |= c - '0';
+        } else if ((c >= 'A') && (c <= 'F')) {
+            v |= c - 'A' + 10;
+        } else if ((c >= 'a') && (c <= 'f')) {
+            v |= c - 'a' + 10;
+        } else {
+            return -1;
+        }
+    }
+    return v;
+}
+
+static int parse_hex(const uint8_t *buf, size_t len, flat_t *f) {
+    const char *data = (const char*)buf;
+    uint32_t base = 0;
+    uint8_t rec[0x105];
+    size_t pos = 0;
+    while (pos < len) {
+        if (data[pos] != ':') {
+            pos++;
+            continue;
+        }
+        int cnt = (pos + 3 <= len) ? get_hex(&data[pos + 1], 2) : -1;
+        if ((cnt < 0) || (pos + 11 + 2 * cnt > len)) {
+            return -1;
+        }
+        uint8_t sum = 0;
+        for (int i = 0; i < cnt + 5; i++) {
+            int b = get_hex(&data[pos + 1 + 2 * i], 2);
+            if (b < 0) {
+                return -1;
+            }
+            rec[i] = b;
+            sum += b;
+        }
+        if (sum != 0) {
+            return -1;
+        }
+        pos += 11 + 2 * cnt;
+        uint32_t addr = rec[1] << 8 | rec[2];
+        switch (rec[3]) {
+        case 0x00:
+            flat_put(f, base + addr, &rec[4], cnt);
+            break;
+        case 0x01:
+            return 0;
+        case 0x02:
+            base = (rec[4] << 8 | rec[5]) << 4;
+            break;
+        case 0x04:
+            base = (uint32_t)(rec[4] << 8 | rec[5]) << 16;
+            break;
+        default:
+            break;
+        }
+    }
+    return 0;
+}
+
+/* Returns nonzero if the input was ELF or HEX. The buffer is replaced with the flat image */
+static int load_sparse(uint8_t **pbuf, size_t *pblen, size_t *plength) {
+    const uint8_t *data = *pbuf;
+    size_t len = *plength;
+    int (*parse)(const uint8_t*, size_t, flat_t*);
+    if ((len > 4) && (memcmp(data, "\x7F" "ELF", 4) == 0)) {
+        parse = parse_elf;
+    } else if ((len > 0) && (data[0] == ':')) {
+        parse = parse_hex;
+    } else {
+        return 0;
+    }
+    flat_t f = {NULL, 0xFFFFFFFFUL, 0};
+    if ((parse(data, len, &f) != 0) || (f.hi <= f.lo)) {
+        printf("Failed to parse input file.\n");
+        exit(4);
+    }
+    size_t length = f.hi - f.lo;
+    if (length > 0x1000000) {
+        printf("Image spans 0x%08X..0x%08X. Check the load addresses.\n", f.lo, f.hi);
+        exit(4);
+    }
+    size_t blen = SEALED_LEN(length) + 0x1000;
+    f.buf = malloc(blen);
+    if (f.buf == NULL) {
+        printf("Failed to allocate buffer. length %zd\n", blen);
+        exit(3);
+    }
+    memset(f.buf, ERASED_BYTE, blen);
+    parse(data, len, &f);
+    printf("Image at 0x%08X, %zd bytes, gaps filled with 0x%02X\n", f.lo, length, ERASED_BYTE);
+    free(*pbuf);
+    *pbuf = f.buf;
+    *pblen = blen;
+    *plength = length;
+    return 1;
+}
+
+static uint8_t *patch_dst;
+
+static uint8_t patch_test_write(size_t offset, const void *data, size_t len) {
+    memcpy(&patch_dst[offset], data, len);
+    return PATCH_OK;
+}
+
+/* Replaces the image in the buffer with the patch from the old image or with
+ * the compressed image if there is no old one. The old image gets the same
+ * checksum processing, so it matches the device flash.
+ */
+static size_t make_patch(uint8_t **pbuf, size_t *pblen, size_t length, const char *oldfile, size_t wsize, int crc) {
+    FILE *fo = NULL;
+    size_t olen = 0;
+    if (oldfile != NULL) {
+        fo = fopen(oldfile, "rb");
+        if (fo == NULL) {
+            printf("Failed to open file: %s\n", oldfile);
+            exit(1);
+        }
+        fseek(fo, 0, SEEK_END);
+        olen = ftell(fo);
+        fseek(fo, 0, SEEK_SET);
+    }
+    size_t oblen = olen + 0x1000;
+    size_t plen = SEALED_LEN(2 * length) + 0x1000;
+    uint32_t *old = malloc(oblen);
+    uint8_t *pbuf8 = malloc(plen);
+    uint8_t *win = malloc(wsize);
+    if ((old == NULL) || (pbuf8 == NULL) || (win == NULL)) {
+        printf("Failed to allocate buffer.\n");
+        exit(3);
+    }
+    size_t base_length = 0;
+    uint32_t base_digest = 0;
+    if (fo != NULL) {
+        if (olen != fread(old, 1, olen, fo)) {
+            printf("Failed to read old file.");
+            exit(4);
+        }
+        fclose(fo);
+#if (DFU_VERIFY_CHECKSUM != _DISABLE)
+        if (crc) {
+            base_length = validate_checksum(old, oblen);
+            if (base_length == 0) {
+                /* not processed yet */
+                base_length = olen;
+                olen = append_checksum(old, olen, oblen);
+                if (olen == 0) {
+                    printf("Failed to append checksum to the old image.\n");
+                    exit(-2);
+                }
+            }
+            const uint8_t *d = (const uint8_t*)old + base_length;
+            base_digest = d[0] | d[1] << 8 | d[2] << 16 | (uint32_t)d[3] << 24;
+        }
+#endif
+    }
+    (void)crc;
+
+    size_t res = patch_encode(pbuf8, plen, *pbuf, length, old, olen, wsize);
+    if (res == 0) {
+        printf("Failed to make patch.\n");
+        exit(-5);
+    }
+    struct patch_header *hdr = (void*)pbuf8;
+    hdr->base_length = base_length;
+    hdr->base_digest = base_digest;
+    if (oldfile != NULL) {
+        printf("Patch from %s: %zd bytes for %zd bytes image, window 0x%zX\n", oldfile, res, length, wsize);
+    } else {
+        printf("Compressed %zd bytes to %zd bytes, window 0x%zX\n", length, res, wsize);
+    }
+
+    /* apply it the same way the device does */
+    printf("Validating patch. ");
+    size_t dlen = (olen > length) ? olen : length;
+    uint8_t *dst = malloc(dlen);
+    if (dst == NULL) {
+        printf("Failed to allocate buffer.\n");
+        exit(3);
+    }
+    memset(dst, ERASED_BYTE, dlen);
+    memcpy(dst, old, olen);
+    patch_dst = dst;
+    patch_init(dst, dst, dlen, win, wsize, base_length, base_digest, patch_test_write);
+    uint8_t status = patch_update(pbuf8, res);
+    if (status == PATCH_OK) {
+        status = patch_final();
+    }
+    if ((status != PATCH_OK) || memcmp(dst, *pbuf, length)) {
+        printf("FAIL. Status %d\n", status);
+        exit(-3);
+    }
+    printf("OK.\n");
+
+    free(old);
+    free(dst);
+    free(win);
+    free(*pbuf);
+    *pbuf = pbuf8;
+    *pblen = plen;
+    return res;
+}
+
+#if (DFU_TAGSZ != 0)
+/* random ID of the sealed image */
+static void make_image_id(uint32_t *id) {
+    do {
+#if defined(_WIN32)
+        rand_s(&id[0]);
+        rand_s(&id[1]);
+#else
+        FILE *fr = fopen("/dev/urandom", "rb");
+        if (fr == NULL) {
+            printf("Failed to open /dev/urandom.\n");
+            exit(5);
+        }
+        size_t res = fread(id, sizeof(uint32_t), 2, fr);
+        fclose(fr);
+        if (res != 2) {
+            printf("Failed to read /dev/urandom.\n");
+            exit(5);
+        }
+#endif
+    } while ((id[0] | id[1]) == 0);
+}
+
+/* Authenticated mode output is framed by DFU blocks. Every DFU_BLOCKSZ block
+ * is followed by its tag, so the one DFU transfer carries one sealed block.
+ * The nonce block with the random image ID goes first.
+ */
+static size_t seal_blocks(uint8_t *buf, size_t length) {
+    const size_t frame = DFU_BLOCKSZ + DFU_TAGSZ;
+    size_t count = (length + DFU_BLOCKSZ - 1) / DFU_BLOCKSZ;
+    uint32_t id[2];
+    /* spread blocks to their framed positions starting from the last one */
+    for (size_t i = count; i-- > 0; ) {
+        size_t sz = (i == count - 1) ? length - i * DFU_BLOCKSZ : DFU_BLOCKSZ;
+        memmove(&buf[(i + 1) * frame], &buf[i * DFU_BLOCKSZ], sz);
+    }
+    make_image_id(id);
+    printf("Image ID: %08X%08X\n", (unsigned)id[1], (unsigned)id[0]);
+    size_t olen = aes_seal_nonce(buf, id);
+    for (size_t i = 0; i < count; i++) {
+        size_t sz = (i == count - 1) ? length - i * DFU_BLOCKSZ : DFU_BLOCKSZ;
+        olen += aes_seal(&buf[olen], &buf[olen], sz);
+    }
+    return olen;
+}
+
+static size_t open_blocks(uint8_t *buf, size_t length) {
+    size_t olen = 0;
+    for (size_t pos = 0; pos < length; pos += DFU_BLOCKSZ + DFU_TAGSZ) {
+        size_t sz = length - pos;
+        if (sz > DFU_BLOCKSZ + DFU_TAGSZ) {
+            sz = DFU_BLOCKSZ + DFU_TAGSZ;
+        }
+        int res = aes_open(&buf[pos], &buf[pos], sz);
+        if (res < 0) {
+            printf("Authentication failed at offset %zd\n", pos);
+            exit(-4);
+        }
+        memmove(&buf[olen], &buf[pos], res);
+        olen += res;
+    }
+    return olen;
+}
+#endif
+
 int main(int argc, char **argv)
 {
     int dir = 1;
@@ -133,12 +467,15 @@ int main(int argc, char **argv)
     int enc = 1;
     char *infile = NULL;
     char *outfile = NULL;
+    char *oldfile = NULL;
+    int zip = 0;
+    size_t wsize = PATCH_WINDOW;
     int c;
     uint32_t vidpid = 0;
 
     opterr = 0;
 
-    while ((c = getopt(argc, argv, "edchnCi:o:v:")) != -1)
+    while ((c = getopt(argc, argv, "edchnzCi:o:v:D:w:")) != -1)
         switch (c)
         {
         case 'C':
@@ -169,6 +506,19 @@ int main(int argc, char **argv)
                 exit(-1);
             }
             break;
+        case 'D':
+            oldfile = optarg;
+            break;
+        case 'z':
+            zip = 1;
+            break;
+        case 'w':
+            wsize = strtoul(optarg, NULL, 0);
+            if ((wsize < 4) || (wsize & (wsize - 1)) || (wsize > 0x8000)) {
+                printf("Invalid patch window size :\"%s\"\n", optarg);
+                exit(-1);
+            }
+            break;
         case 'h':
         case '?':
             exithelp();
@@ -197,7 +547,7 @@ int main(int argc, char **argv)
     fseek(fi, 0, SEEK_SET);
 
 
-    size_t   blen = length + 0x1000;
+    size_t   blen = SEALED_LEN(length) + 0x1000;
     uint32_t *buf = malloc(blen);
     uint8_t  *buf8 = (uint8_t*)buf;
 
@@ -212,11 +562,25 @@ int main(int argc, char **argv)
     }
     fclose(fi);
 
+    if (load_sparse(&buf8, &blen, &length)) {
+        buf = (uint32_t*)buf8;
+#if (DFU_PATCH == _ENABLE)
+        if (dir && (oldfile == NULL)) {
+            /* erased gaps are sent as the fill operations */
+            zip = 1;
+        }
+#endif
+    }
+
     aes_init();
     if (dir) {
 #if (DFU_VERIFY_CHECKSUM != _DISABLE)
         if (crc) {
             size_t newlen = append_checksum(buf, length, blen);
+            if (newlen == 0) {
+                printf("Failed to append checksum. Vector table entries 0x1C..0x2B must be zero.\n");
+                exit(-2);
+            }
 
             printf("Firmware length: %zd bytes, signature: (%s) %s\n",
                    length,
@@ -228,22 +592,32 @@ int main(int argc, char **argv)
             size_t checked_length = validate_checksum(buf, blen);
 
             if (checked_length != length ) {
-                printf("FAIL. Collision found at offset %zd\n", checked_length);
+                printf("FAIL. Checked length %zd\n", checked_length);
                 exit(-3);
             } else {
                 printf("OK.\n");
             }
+            print_digest(buf8, newlen);
             length = newlen;
         }
 #endif
 
+        if ((oldfile != NULL) || zip) {
+            length = make_patch(&buf8, &blen, length, oldfile, wsize, crc);
+            buf = (uint32_t*)buf8;
+        }
+
 #if(DFU_CIPHER != _DISABLE)
         if (enc) {
             if (length % aes_blksize) {
                 length += (aes_blksize - (length % aes_blksize));
             }
             printf("Encrypting %zd bytes using %s cipher.\n", length, aes_name);
+#if (DFU_TAGSZ != 0)
+            length = seal_blocks(buf8, length);
+#else
             aes_encrypt(buf, buf, length);
+#endif
         } else {
             printf("Skipping encryption.\n");
         }
@@ -269,7 +643,11 @@ int main(int argc, char **argv)
 #if(DFU_CIPHER != _DISABLE)
         if (enc) {
             printf("Decrypting %zd bytes using %s cipher.\n", length, aes_name);
+#if (DFU_TAGSZ != 0)
+            length = open_blocks(buf8, length);
+#else
             aes_decrypt(buf, buf, length);
+#endif
         } else {
             printf("Skipping decryption.\n");
         }
@@ -22,7 +22,11 @@
 
 #define rounds 32
 
+#if defined(GOST_ROMKEYS)
+static const uint32_t RK[32] = {GOST_ROMKEYS};
+#else
 static uint32_t RK[32];
+#endif
 
 static const uint32_t S[] = {
     0xC6BC7581, 0x4838FDE7, 0x62525F2E, 0x2381A65D,
@@ -74,6 +78,9 @@ void gost_decrypt(uint32_t *out, const uint32_t *in) {
 }
 
 void gost_init(const void* key){
+#if defined(GOST_ROMKEYS)
+    (void)key;
+#else
     const uint8_t *K = key;
     for (int i = 0; i < 8; i++) {
         RK[i] = K[4*i] << 24 | K[4*i+1] << 16 | K[4*i+2] << 8 | K[4*i+3];
@@ -81,4 +88,5 @@ void gost_init(const void* key){
         RK[16+i] = RK[i];
         RK[31-i] = RK[i];
     }
+#endif
 }
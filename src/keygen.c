@@ -0,0 +1,94 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Host tool. Expands the configured key with the cipher's own init code
+ * and writes the key schedule as a header for the DFU_CIPHER_ROMKEYS build.
+ * Cipher source is included to get access to the static key schedule.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "config.h"
+#include "crypto.c"
+
+#if (DFU_CIPHER == DFU_CIPHER_RC5)
+    #include "rc5.c"
+    #define dump_keys(f) dump(f, "RC5_ROMKEYS", rc5_keys, sizeof(rc5_keys))
+#elif (DFU_CIPHER == DFU_CIPHER_RC6)
+    #include "rc6.c"
+    #define dump_keys(f) dump(f, "RC6_ROMKEYS", RK, sizeof(RK))
+#elif (DFU_CIPHER == DFU_CIPHER_SPECK)
+    #include "speck.c"
+    #define dump_keys(f) dump(f, "SPECK_ROMKEYS", roundkey, sizeof(roundkey))
+#elif (DFU_CIPHER == DFU_CIPHER_GOST)
+    #include "gost.c"
+    #define dump_keys(f) dump(f, "GOST_ROMKEYS", RK, sizeof(RK))
+#elif (DFU_CIPHER == DFU_CIPHER_MAGMA)
+    #include "magma.c"
+    #define dump_keys(f) dump(f, "MAGMA_ROMKEYS", RK, sizeof(RK))
+#elif (DFU_CIPHER == DFU_CIPHER_XTEA)
+    #include "xtea.c"
+    #define dump_keys(f) dump(f, "XTEA_ROMKEYS", K, sizeof(K))
+#elif (DFU_CIPHER == DFU_CIPHER_XTEA1)
+    #include "xtea1.c"
+    #define dump_keys(f) dump(f, "XTEA1_ROMKEYS", K, sizeof(K))
+#elif (DFU_CIPHER == DFU_CIPHER_RTEA)
+    #include "rtea.c"
+    #define dump_keys(f) dump(f, "RTEA_ROMKEYS", K, sizeof(K))
+#elif (DFU_CIPHER == DFU_CIPHER_RAIDEN)
+    #include "raiden.c"
+    #define dump_keys(f) dump(f, "RAIDEN_ROMKEYS", subkey, sizeof(subkey))
+#elif (DFU_CIPHER == DFU_CIPHER_RIJNDAEL)
+    #include "rijndael.c"
+    #define dump_keys(f) dump(f, "RIJNDAEL_ROMKEYS", roundkey, sizeof(roundkey))
+#elif (DFU_CIPHER == DFU_CIPHER_BLOWFISH)
+    #include "blowfish.c"
+    #define dump_keys(f) do {                                    \
+        dump(f, "BLOWFISH_ROMKEYS_P", D.P, sizeof(D.P));         \
+        dump(f, "BLOWFISH_ROMKEYS_S0", D.S[0], sizeof(D.S[0]));  \
+        dump(f, "BLOWFISH_ROMKEYS_S1", D.S[1], sizeof(D.S[1]));  \
+        dump(f, "BLOWFISH_ROMKEYS_S2", D.S[2], sizeof(D.S[2]));  \
+        dump(f, "BLOWFISH_ROMKEYS_S3", D.S[3], sizeof(D.S[3]));  \
+    } while (0)
+#else
+    #error ROM key schedule is supported only for the C block ciphers. Check config !!
+#endif
+
+static void dump(FILE *f, const char *name, const uint32_t *data, size_t sz) {
+    fprintf(f, "#define %s", name);
+    for (size_t i = 0; i < sz / sizeof(uint32_t); i++) {
+        fprintf(f, "%s0x%08X", (i == 0) ? " \\\n    " : (i % 6) ? ", " : ", \\\n    ", data[i]);
+    }
+    fprintf(f, "\n\n");
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        printf("Usage: keygen <output header>\n");
+        return 1;
+    }
+    FILE *f = fopen(argv[1], "w");
+    if (f == NULL) {
+        printf("Failed to open output file %s\n", argv[1]);
+        return 2;
+    }
+    aes_init();
+    fprintf(f, "/* This file is automatically generated. %s key schedule */\n", aes_name);
+    fprintf(f, "#ifndef _ROMKEYS_H_\n#define _ROMKEYS_H_\n\n");
+    dump_keys(f);
+    fprintf(f, "#endif\n");
+    fclose(f);
+    return 0;
+}
@@ -23,7 +23,11 @@
 
 #define rounds 32
 
+#if defined(MAGMA_ROMKEYS)
+static const uint32_t RK[32] = {MAGMA_ROMKEYS};
+#else
 static uint32_t RK[32];
+#endif
 
 static const uint32_t S[] = {
     0xC6BC7581, 0x4838FDE7, 0x62525F2E, 0x2381A65D,
@@ -75,6 +79,9 @@ void magma_decrypt(uint32_t *out, const uint32_t *in) {
 }
 
 void magma_init(const void* key){
+#if defined(MAGMA_ROMKEYS)
+    (void)key;
+#else
     for (int i = 0; i < 8; i++) {
         uint32_t K;
         memcpy(&K, key, sizeof(K));
@@ -85,4 +92,5 @@ void magma_init(const void* key){
         RK[0x1F - i] = K;
         key += 4;
     }
+#endif
 }
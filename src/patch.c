@@ -0,0 +1,270 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Streaming patch decoder. The new image is assembled in the RAM window and
+ * written over the old one when the window is full. Until then the old data
+ * under the window is still in place and can be copied from. New data below
+ * the window is read back from the destination.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "patch.h"
+
+static struct patch_state_s {
+    const uint8_t       *base;
+    const uint8_t       *dest;
+    size_t              limit;
+    uint8_t             *win;
+    size_t              wsize;
+    patch_write_fn      write;
+    size_t              base_length;
+    uint32_t            base_digest;
+    struct patch_header hdr;
+    size_t              pos;        /* stream position */
+    size_t              out;        /* new image position */
+    size_t              wstart;     /* window position in the new image */
+    uint32_t            arg[2];
+    uint8_t             op;
+    uint8_t             idx;        /* argument being decoded */
+    uint8_t             shift;
+    uint8_t             status;
+} patch;
+
+static uint8_t patch_nargs(uint8_t op) {
+    switch (op) {
+    case PATCH_OP_LITERAL:
+        return 1;
+    case PATCH_OP_COPY:
+    case PATCH_OP_MATCH:
+    case PATCH_OP_FILL:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+static uint8_t patch_check_header(void) {
+    const struct patch_header *hdr = &patch.hdr;
+    if ((hdr->magic != PATCH_MAGIC) || (hdr->version != PATCH_VERSION) ||
+        (hdr->window == 0) || (hdr->window & (hdr->window - 1)) || (patch.wsize % hdr->window) ||
+        (hdr->size < sizeof(struct patch_header))) {
+        return PATCH_ERR_FILE;
+    }
+    if (hdr->length > patch.limit) {
+        return PATCH_ERR_ADDRESS;
+    }
+    if ((hdr->base_length != 0) &&
+        ((hdr->base_length != patch.base_length) || (hdr->base_digest != patch.base_digest))) {
+        return PATCH_ERR_FILE;
+    }
+    return PATCH_OK;
+}
+
+static void patch_flush(void) {
+    size_t fill = patch.out - patch.wstart;
+    if (fill != 0) {
+        patch.status = patch.write(patch.wstart, patch.win, fill);
+    }
+    patch.wstart = patch.out;
+}
+
+/* appends data or len bytes of value to the window. Full window is written out */
+static void patch_emit(const uint8_t *data, uint8_t value, size_t len) {
+    while ((len != 0) && (patch.status == PATCH_OK)) {
+        size_t fill = patch.out - patch.wstart;
+        size_t cnt = patch.wsize - fill;
+        if (cnt > len) {
+            cnt = len;
+        }
+        if (patch.out + cnt > patch.hdr.length) {
+            patch.status = PATCH_ERR_FILE;
+            return;
+        }
+        if (data != NULL) {
+            memcpy(&patch.win[fill], data, cnt);
+            data += cnt;
+        } else {
+            memset(&patch.win[fill], value, cnt);
+        }
+        patch.out += cnt;
+        len -= cnt;
+        if (fill + cnt == patch.wsize) {
+            patch_flush();
+        }
+    }
+}
+
+/* copies old data. Data below the window is already overwritten */
+static void patch_copy(size_t offset, size_t len) {
+    while ((len != 0) && (patch.status == PATCH_OK)) {
+        size_t cnt = patch.wsize - (patch.out - patch.wstart);
+        if (cnt > len) {
+            cnt = len;
+        }
+        if ((offset < patch.wstart) || (offset + cnt > patch.limit)) {
+            patch.status = PATCH_ERR_ADDRESS;
+            return;
+        }
+        patch_emit(patch.base + offset, 0, cnt);
+        offset += cnt;
+        len -= cnt;
+    }
+}
+
+/* repeats new data. Source may overlap the output */
+static void patch_match(size_t dist, size_t len) {
+    if ((dist == 0) || (dist > patch.out)) {
+        patch.status = PATCH_ERR_FILE;
+        return;
+    }
+    while ((len != 0) && (patch.status == PATCH_OK)) {
+        size_t src = patch.out - dist;
+        size_t cnt = patch.wsize - (patch.out - patch.wstart);
+        if (cnt > len) {
+            cnt = len;
+        }
+        if (cnt > dist) {
+            cnt = dist;
+        }
+        if (src >= patch.wstart) {
+            patch_emit(&patch.win[src - patch.wstart], 0, cnt);
+        } else {
+            if (cnt > patch.wstart - src) {
+                cnt = patch.wstart - src;
+            }
+            patch_emit(patch.dest + src, 0, cnt);
+        }
+        len -= cnt;
+    }
+}
+
+static void patch_execute(void) {
+    switch (patch.op) {
+    case PATCH_OP_COPY:
+        patch_copy(patch.arg[1], patch.arg[0]);
+        patch.op = 0;
+        break;
+    case PATCH_OP_MATCH:
+        patch_match(patch.arg[1], patch.arg[0]);
+        patch.op = 0;
+        break;
+    case PATCH_OP_FILL:
+        if (patch.arg[1] > 0xFF) {
+            patch.status = PATCH_ERR_FILE;
+        }
+        patch_emit(NULL, patch.arg[1], patch.arg[0]);
+        patch.op = 0;
+        break;
+    case PATCH_OP_LITERAL:
+        /* data follows */
+        if (patch.arg[0] == 0) {
+            patch.op = 0;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void patch_init(const void *base, const void *dest, size_t limit, void *window, size_t wsize,
+                size_t base_length, uint32_t base_digest, patch_write_fn write) {
+    memset(&patch, 0, sizeof(patch));
+    patch.base = base;
+    patch.dest = dest;
+    patch.limit = limit;
+    patch.win = window;
+    patch.wsize = wsize;
+    patch.base_length = base_length;
+    patch.base_digest = base_digest;
+    patch.write = write;
+}
+
+uint8_t patch_update(const void *data, size_t len) {
+    const uint8_t *src = data;
+    while ((len != 0) && (patch.status == PATCH_OK)) {
+        if (patch.pos < sizeof(struct patch_header)) {
+            ((uint8_t*)&patch.hdr)[patch.pos++] = *src++;
+            len--;
+            if (patch.pos == sizeof(struct patch_header)) {
+                patch.status = patch_check_header();
+            }
+            continue;
+        }
+        if (patch.pos >= patch.hdr.size) {
+            /* cipher padding */
+            break;
+        }
+        if ((patch.op == PATCH_OP_LITERAL) && (patch.idx == 1)) {
+            size_t cnt = patch.hdr.size - patch.pos;
+            if (cnt > len) {
+                cnt = len;
+            }
+            if (cnt > patch.arg[0]) {
+                cnt = patch.arg[0];
+            }
+            patch_emit(src, 0, cnt);
+            src += cnt;
+            len -= cnt;
+            patch.pos += cnt;
+            patch.arg[0] -= cnt;
+            if (patch.arg[0] == 0) {
+                patch.op = 0;
+            }
+            continue;
+        }
+        uint8_t b = *src++;
+        len--;
+        patch.pos++;
+        if (patch.op == 0) {
+            if (patch_nargs(b) == 0) {
+                patch.status = PATCH_ERR_FILE;
+                break;
+            }
+            patch.op = b;
+            patch.idx = 0;
+            patch.shift = 0;
+            patch.arg[0] = 0;
+            patch.arg[1] = 0;
+            continue;
+        }
+        if (patch.shift > 28) {
+            patch.status = PATCH_ERR_FILE;
+            break;
+        }
+        patch.arg[patch.idx] |= (uint32_t)(b & 0x7F) << patch.shift;
+        patch.shift += 7;
+        if ((b & 0x80) == 0) {
+            patch.shift = 0;
+            if (++patch.idx == patch_nargs(patch.op)) {
+                patch_execute();
+            }
+        }
+    }
+    return patch.status;
+}
+
+uint8_t patch_final(void) {
+    if (patch.status != PATCH_OK) {
+        return patch.status;
+    }
+    if ((patch.pos < sizeof(struct patch_header)) || (patch.pos < patch.hdr.size) ||
+        (patch.op != 0) || (patch.out != patch.hdr.length)) {
+        return PATCH_ERR_NOTDONE;
+    }
+    patch_flush();
+    return patch.status;
+}
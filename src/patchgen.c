@@ -0,0 +1,240 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Host side patch encoder. Greedy matching over the hash chains of the old
+ * and the new image and the byte runs. Copies from below the current output window are not allowed, because
+ * the device has already overwritten them.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "patch.h"
+
+#define HASH_BITS   16
+#define MIN_MATCH   8
+#define MIN_GAIN    3
+#define MAX_CHAIN   64
+/* boot record may be stored there on the device. See checksum.h */
+#define REC_START   0x20
+#define REC_END     0x28
+
+struct patch_out {
+    uint8_t     *buf;
+    size_t      size;
+    size_t      len;
+};
+
+static void put_byte(struct patch_out *po, uint8_t b) {
+    if (po->len < po->size) {
+        po->buf[po->len] = b;
+    }
+    po->len++;
+}
+
+static void put_varint(struct patch_out *po, uint32_t v) {
+    while (v > 0x7F) {
+        put_byte(po, (v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    put_byte(po, v);
+}
+
+static void put_literal(struct patch_out *po, const uint8_t *data, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    put_byte(po, PATCH_OP_LITERAL);
+    put_varint(po, len);
+    while (len--) {
+        put_byte(po, *data++);
+    }
+}
+
+static uint32_t hash4(const uint8_t *p) {
+    uint32_t v = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+    return (uint32_t)(v * 2654435761UL) >> (32 - HASH_BITS);
+}
+
+static size_t varint_size(uint32_t v) {
+    size_t n = 1;
+    while (v > 0x7F) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+/* hash chains, highest offsets come first */
+static int32_t *chain_init(void) {
+    int32_t *head = malloc(sizeof(int32_t) << HASH_BITS);
+    if (head != NULL) {
+        memset(head, 0xFF, sizeof(int32_t) << HASH_BITS);
+    }
+    return head;
+}
+
+static void chain_insert(int32_t *head, int32_t *prev, const uint8_t *data, size_t len, size_t i) {
+    prev[i] = -1;
+    if (i + 4 <= len) {
+        uint32_t h = hash4(&data[i]);
+        prev[i] = head[h];
+        head[h] = i;
+    }
+}
+
+/* length of the old data match at s for the new data at x */
+static size_t copy_length(const uint8_t *img, size_t len, size_t x,
+                          const uint8_t *base, size_t baselen, size_t s, size_t wsize) {
+    size_t n = 0;
+    while ((x + n < len) && (s + n < baselen) && (img[x + n] == base[s + n])) {
+        if ((s + n >= REC_START) && (s + n < REC_END)) {
+            break;
+        }
+        /* source must not be below the window of the output */
+        if (s + n < ((x + n) & ~(wsize - 1))) {
+            break;
+        }
+        n++;
+    }
+    return n;
+}
+
+/* length of the new data match at s < x. May overlap */
+static size_t match_length(const uint8_t *img, size_t len, size_t x, size_t s) {
+    size_t n = 0;
+    while ((x + n < len) && (img[x + n] == img[s + n])) {
+        n++;
+    }
+    return n;
+}
+
+size_t patch_encode(void *out, size_t outsz, const void *img, size_t len,
+                    const void *base, size_t baselen, size_t wsize) {
+    const uint8_t *src = img;
+    const uint8_t *old = base;
+    struct patch_out po = {out, outsz, sizeof(struct patch_header)};
+    int32_t *ohead = chain_init();
+    int32_t *nhead = chain_init();
+    int32_t *oprev = malloc(sizeof(int32_t) * (baselen + 1));
+    int32_t *nprev = malloc(sizeof(int32_t) * (len + 1));
+    if ((ohead == NULL) || (nhead == NULL) || (oprev == NULL) || (nprev == NULL)) {
+        free(ohead);
+        free(nhead);
+        free(oprev);
+        free(nprev);
+        return 0;
+    }
+    for (size_t i = 0; i < baselen; i++) {
+        chain_insert(ohead, oprev, old, baselen, i);
+    }
+
+    size_t lit = 0;
+    size_t x = 0;
+    size_t ins = 0;
+    size_t delta = 0;
+    while (x < len) {
+        /* new data up to x is available for the matches */
+        while (ins < x) {
+            chain_insert(nhead, nprev, src, len, ins++);
+        }
+        uint8_t op = 0;
+        size_t best = 0;
+        size_t arg = 0;
+        int gain = 0;
+        /* unchanged and shifted code is found without the chain lookup */
+        size_t cand[2] = {x, x + delta};
+        for (int i = 0; i < 2; i++) {
+            size_t n = copy_length(src, len, x, old, baselen, cand[i], wsize);
+            int g = (int)n - 1 - (int)varint_size(n) - (int)varint_size(cand[i]);
+            if (g > gain) {
+                op = PATCH_OP_COPY;
+                best = n;
+                arg = cand[i];
+                gain = g;
+            }
+        }
+        if ((best < MIN_MATCH) && (x + 4 <= len)) {
+            size_t lo = x & ~(wsize - 1);
+            int32_t s = ohead[hash4(&src[x])];
+            for (int i = 0; (s >= 0) && ((size_t)s >= lo) && (i < MAX_CHAIN); s = oprev[s], i++) {
+                size_t n = copy_length(src, len, x, old, baselen, s, wsize);
+                int g = (int)n - 1 - (int)varint_size(n) - (int)varint_size(s);
+                if (g > gain) {
+                    op = PATCH_OP_COPY;
+                    best = n;
+                    arg = s;
+                    gain = g;
+                }
+            }
+        }
+        if (x + 4 <= len) {
+            int32_t s = nhead[hash4(&src[x])];
+            for (int i = 0; (s >= 0) && (i < MAX_CHAIN); s = nprev[s], i++) {
+                size_t n = match_length(src, len, x, s);
+                int g = (int)n - 1 - (int)varint_size(n) - (int)varint_size(x - s);
+                if (g > gain) {
+                    op = PATCH_OP_MATCH;
+                    best = n;
+                    arg = x - s;
+                    gain = g;
+                }
+            }
+        }
+        size_t run = 1;
+        while ((x + run < len) && (src[x + run] == src[x])) {
+            run++;
+        }
+        int g = (int)run - 2 - (int)varint_size(run);
+        if (g > gain) {
+            op = PATCH_OP_FILL;
+            best = run;
+            arg = src[x];
+            gain = g;
+        }
+        /* the op must save more than a literal run restart */
+        if (gain < MIN_GAIN) {
+            x++;
+            continue;
+        }
+        put_literal(&po, &src[lit], x - lit);
+        put_byte(&po, op);
+        put_varint(&po, best);
+        put_varint(&po, arg);
+        if (op == PATCH_OP_COPY) {
+            delta = arg - x;
+        }
+        x += best;
+        lit = x;
+    }
+    put_literal(&po, &src[lit], x - lit);
+    free(ohead);
+    free(nhead);
+    free(oprev);
+    free(nprev);
+
+    if (po.len > outsz) {
+        return 0;
+    }
+    struct patch_header *hdr = out;
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = PATCH_MAGIC;
+    hdr->version = PATCH_VERSION;
+    hdr->window = wsize;
+    hdr->size = po.len;
+    hdr->length = len;
+    return po.len;
+}
@@ -0,0 +1,160 @@
+/* This file is the part of the STM32 secure bootloader
+ *
+ * Poly1305 message authentication code implementation based on RFC8439
+ * "ChaCha20 and Poly1305 for IETF Protocols"
+ * https://tools.ietf.org/html/rfc8439
+ *
+ * Copyright ©2016 Dmitry Filimonchuk <dmitrystu[at]gmail[dot]com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "poly1305.h"
+
+/* 130-bit accumulator and key are kept in 26-bit limbs, so all products
+ * fit 64-bit and there is no carry handling inside the block loop. */
+#define MASK26  0x3FFFFFF
+
+static uint32_t r[5];
+static uint32_t h[5];
+static uint32_t pad[4];
+static uint8_t  buffer[16];
+static uint8_t  leftover;
+
+static uint32_t le32(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void poly1305_blocks(const uint8_t *m, size_t sz, uint32_t hibit) {
+    const uint32_t r0 = r[0], r1 = r[1], r2 = r[2], r3 = r[3], r4 = r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+    while (sz >= 16) {
+        uint64_t d0, d1, d2, d3, d4;
+        uint32_t c;
+        /* h += m */
+        h0 += (le32(m +  0)     ) & MASK26;
+        h1 += (le32(m +  3) >> 2) & MASK26;
+        h2 += (le32(m +  6) >> 4) & MASK26;
+        h3 += (le32(m +  9) >> 6) & MASK26;
+        h4 += (le32(m + 12) >> 8) | hibit;
+        /* h *= r */
+        d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+        /* partial h %= p */
+        c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & MASK26;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & MASK26;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & MASK26;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & MASK26;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & MASK26;
+        h0 += c * 5; c = h0 >> 26; h0 &= MASK26;
+        h1 += c;
+        m += 16;
+        sz -= 16;
+    }
+    h[0] = h0; h[1] = h1; h[2] = h2; h[3] = h3; h[4] = h4;
+}
+
+void poly1305_init(const void *key) {
+    const uint8_t *k = key;
+    /* r &= 0x0ffffffc0ffffffc0ffffffc0fffffff */
+    r[0] = (le32(k +  0)     ) & 0x3FFFFFF;
+    r[1] = (le32(k +  3) >> 2) & 0x3FFFF03;
+    r[2] = (le32(k +  6) >> 4) & 0x3FFC0FF;
+    r[3] = (le32(k +  9) >> 6) & 0x3F03FFF;
+    r[4] = (le32(k + 12) >> 8) & 0x00FFFFF;
+    for (int i = 0; i < 4; i++) {
+        pad[i] = le32(k + 16 + 4 * i);
+    }
+    memset(h, 0, sizeof(h));
+    leftover = 0;
+}
+
+void poly1305_update(const void *data, size_t sz) {
+    const uint8_t *m = data;
+    if (leftover) {
+        while (sz && leftover < 16) {
+            buffer[leftover++] = *m++;
+            sz--;
+        }
+        if (leftover < 16) return;
+        poly1305_blocks(buffer, 16, 1UL << 24);
+        leftover = 0;
+    }
+    if (sz >= 16) {
+        size_t full = sz & ~(size_t)0x0F;
+        poly1305_blocks(m, full, 1UL << 24);
+        m += full;
+        sz -= full;
+    }
+    while (sz--) {
+        buffer[leftover++] = *m++;
+    }
+}
+
+void poly1305_finish(void *tag) {
+    uint32_t h0, h1, h2, h3, h4, c;
+    uint32_t g0, g1, g2, g3, g4, mask;
+    uint64_t f;
+    uint8_t *t = tag;
+    /* last partial block padded by 0x01 */
+    if (leftover) {
+        buffer[leftover++] = 0x01;
+        while (leftover < 16) {
+            buffer[leftover++] = 0x00;
+        }
+        poly1305_blocks(buffer, 16, 0);
+    }
+    /* fully carry h */
+    h0 = h[0]; h1 = h[1]; h2 = h[2]; h3 = h[3]; h4 = h[4];
+    c = h1 >> 26; h1 &= MASK26;
+    h2 += c; c = h2 >> 26; h2 &= MASK26;
+    h3 += c; c = h3 >> 26; h3 &= MASK26;
+    h4 += c; c = h4 >> 26; h4 &= MASK26;
+    h0 += c * 5; c = h0 >> 26; h0 &= MASK26;
+    h1 += c;
+    /* g = h - p */
+    g0 = h0 + 5; c = g0 >> 26; g0 &= MASK26;
+    g1 = h1 + c; c = g1 >> 26; g1 &= MASK26;
+    g2 = h2 + c; c = g2 >> 26; g2 &= MASK26;
+    g3 = h3 + c; c = g3 >> 26; g3 &= MASK26;
+    g4 = h4 + c - (1UL << 26);
+    /* select h if h < p, or g otherwise. constant time */
+    mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+    /* h %= 2^128 */
+    h0 = (h0      ) | (h1 << 26);
+    h1 = (h1 >>  6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 <<  8);
+    /* tag = (h + pad) % 2^128 */
+    f = (uint64_t)h0 + pad[0];             h0 = (uint32_t)f;
+    f = (uint64_t)h1 + pad[1] + (f >> 32); h1 = (uint32_t)f;
+    f = (uint64_t)h2 + pad[2] + (f >> 32); h2 = (uint32_t)f;
+    f = (uint64_t)h3 + pad[3] + (f >> 32); h3 = (uint32_t)f;
+    for (int i = 0; i < 4; i++) {
+        t[i]      = (uint8_t)(h0 >> (8 * i));
+        t[i + 4]  = (uint8_t)(h1 >> (8 * i));
+        t[i + 8]  = (uint8_t)(h2 >> (8 * i));
+        t[i + 12] = (uint8_t)(h3 >> (8 * i));
+    }
+}
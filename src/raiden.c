@@ -19,9 +19,14 @@
 
 #include <stdint.h>
 #include <string.h>
+#include "misc.h"
 #include "raiden.h"
 
+#if defined(RAIDEN_ROMKEYS)
+static const uint32_t subkey[0x10] = {RAIDEN_ROMKEYS};
+#else
 static uint32_t subkey[0x10];
+#endif
 
 void raiden_encrypt(uint32_t *out, const uint32_t *in) {
     uint32_t b0 = in[0];
@@ -48,6 +53,9 @@ void raiden_decrypt(uint32_t *out, const uint32_t *in) {
 }
 
 void raiden_init(const void* key) {
+#if defined(RAIDEN_ROMKEYS)
+    (void)key;
+#else
     uint32_t k[4];
     memcpy(k, key, sizeof(k));
     for (int i = 0; i < 16; i++) {
@@ -55,4 +63,5 @@ void raiden_init(const void* key) {
         k[i & 0x03] = sk;
         subkey[i] = sk;
     }
+#endif
 }
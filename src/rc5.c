@@ -29,7 +29,11 @@
 #define Pw          0xb7e15163
 #define Qw          0x9e3779b9
 
+#if defined(RC5_ROMKEYS)
+static const uint32_t rc5_keys[t] = {RC5_ROMKEYS};
+#else
 static uint32_t rc5_keys[t];
+#endif
 
 void rc5_encrypt (uint32_t *out, const uint32_t *in) {
     uint32_t A = in[0] + rc5_keys[0];
@@ -54,6 +58,9 @@ void rc5_decrypt (uint32_t *out, const uint32_t *in) {
 }
 
 void rc5_init (const void* key) {
+#if defined(RC5_ROMKEYS)
+    (void)key;
+#else
     uint32_t L[4];
     memcpy(L, key, 16);
     rc5_keys[0] = Pw;
@@ -66,4 +73,5 @@ void rc5_init (const void* key) {
         if (++i == t) i = 0;
         if (++j == c) j = 0;
     }
+#endif
 }
@@ -30,7 +30,11 @@
 #define Pw          0xb7e15163
 #define Qw          0x9e3779b9
 
+#if defined(RC6_ROMKEYS)
+static const uint32_t RK[SW] = {RC6_ROMKEYS};
+#else
 static uint32_t RK[SW];
+#endif
 
 void rc6_encrypt (uint32_t *out, const uint32_t *in) {
     uint32_t A = in[0];
@@ -79,6 +83,9 @@ void rc6_decrypt (uint32_t *out, const uint32_t *in) {
 }
 
 void rc6_init (const void* key) {
+#if defined(RC6_ROMKEYS)
+    (void)key;
+#else
     uint32_t L[KW];
     memcpy(L, key, sizeof(L));
     RK[0] = Pw;
@@ -91,4 +98,5 @@ void rc6_init (const void* key) {
         if (++i == SW) i = 0;
         if (++j == KW) j = 0;
     }
+#endif
 }
@@ -39,7 +39,11 @@
 typedef uint8_t state_t[4][4];
 
 // Roundkey storage
+#if defined(RIJNDAEL_ROMKEYS)
+static const uint32_t roundkey[RKSIZE32] = {RIJNDAEL_ROMKEYS};
+#else
 static uint32_t roundkey[RKSIZE32];
+#endif
 
 // Basic GF2 math
 static uint8_t gmul2(uint8_t x) {
@@ -53,7 +57,7 @@ static uint8_t gmul2(uint8_t x) {
 #define gmul4(x) gmul2(gmul2(x))
 #define gmul8(x) gmul2(gmul4(x))
 
-#if (RIJNDAEL_ROM_SBOXES == 1)
+#if (RIJNDAEL_ROM_SBOXES == 1) || defined(RIJNDAEL_ROMKEYS)
 
 static const uint8_t sbox[256] = {
     //0     1    2      3     4    5     6     7      8    9     A      B    C     D     E     F
@@ -94,7 +98,7 @@ static const uint8_t rbox[256] = {
     0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d
 };
 
-static void init_sbox(void) { }
+#define init_sbox()
 
 #else //USE_ROM_SBOXES
 
@@ -139,7 +143,7 @@ static void sub_box(void *data, const uint8_t *box, size_t sz) {
 }
 
 static void AddRoundKey(void *dst, const void *src, int round) {
-    uint8_t *rk = (uint8_t*)roundkey + sizeof(state_t) * round;
+    const uint8_t *rk = (const uint8_t*)roundkey + sizeof(state_t) * round;
     for (int i = 0; i < sizeof(state_t); i++) {
         ((uint8_t*)dst)[i] = ((uint8_t*)src)[i] ^ rk[i];
     }
@@ -253,6 +257,9 @@ static void InvShiftRows(state_t* state)
 }
 
 void rijndael_init(const void *key) {
+#if defined(RIJNDAEL_ROMKEYS)
+    (void)key;
+#else
     uint8_t rcon = 0x01;
     init_sbox();
     memcpy(roundkey, key, KEYSIZE);
@@ -273,6 +280,7 @@ void rijndael_init(const void *key) {
         }
         roundkey[i] = temp ^ roundkey[i - KEYSIZE32];
     }
+#endif
 }
 
 void rijndael_encrypt(uint32_t *out, const uint32_t *in) {
@@ -17,11 +17,16 @@
 
 #include <stdint.h>
 #include <string.h>
+#include "misc.h"
 #include "rtea.h"
 
 #define rounds  64
 
+#if defined(RTEA_ROMKEYS)
+static const uint32_t K[8] = {RTEA_ROMKEYS};
+#else
 static uint32_t K[8];
+#endif
 
 void rtea_encrypt(uint32_t *out, const uint32_t *in) {
     uint32_t A = in[0];
@@ -49,5 +54,9 @@ void rtea_decrypt(uint32_t *out, const uint32_t *in) {
 }
 
 void rtea_init(const void* key) {
+#if defined(RTEA_ROMKEYS)
+    (void)key;
+#else
     memcpy(K, key, sizeof(K));
+#endif
 }
@@ -25,7 +25,11 @@
 
 #define ROUNDS  27
 
+#if defined(SPECK_ROMKEYS)
+static const uint32_t roundkey[ROUNDS] = {SPECK_ROMKEYS};
+#else
 static uint32_t roundkey[ROUNDS];
+#endif
 
 inline static void speck_round(uint32_t *a, uint32_t *b, const uint32_t key) {
     *a = key ^ (__ror32(*a, 8) + *b);
@@ -58,6 +62,9 @@ void speck_decrypt(uint32_t *out, const uint32_t *in) {
 }
 
 void speck_init(const void* key) {
+#if defined(SPECK_ROMKEYS)
+    (void)key;
+#else
     uint32_t K[4];
     memcpy(K, key, 16);
     for (int i = 0, j = 0 ; i < ROUNDS; i++) {
@@ -65,4 +72,5 @@ void speck_init(const void* key) {
         if (++j > 3) j = 1;
         speck_round(&K[j], &K[0], i);
     }
+#endif
 }
@@ -30,7 +30,11 @@
 #define RA(x, s, k) ((x << 4) ^ (x >> 5)) + ( x ^ s) + __rol32(k[s & 0x03], x)
 #define RB(x, s, k) ((x << 4) ^ (x >> 5)) + ( x ^ s) + __rol32(k[(s >> 11) & 0x03], x)
 
+#if defined(XTEA1_ROMKEYS)
+static const uint32_t K[4] = {XTEA1_ROMKEYS};
+#else
 static uint32_t K[4];
+#endif
 
 void xtea1_encrypt(uint32_t *out, const uint32_t *in) {
     uint32_t A = in[0];
@@ -59,5 +63,9 @@ void xtea1_decrypt(uint32_t *out, const uint32_t *in) {
 }
 
 void xtea1_init(const void* key) {
+#if defined(XTEA1_ROMKEYS)
+    (void)key;
+#else
     memcpy(K, key, sizeof(K));
+#endif
 }